@@ -28,6 +28,9 @@ include(build-paths.pri)
 QT += 3dcore 3drender 3dinput 3dlogic 3dextras concurrent
 QT += widgets core
 
+# the signal spy callbacks of the block profiler
+QT += core-private
+
 qtCompileTest(serialport) {
     QT += serialport
     DEFINES += SERIALPORT_ENABLED
@@ -64,9 +67,13 @@ SOURCES += \
     src/block/PoseSimulation.cpp \
     src/block/TractorModel.cpp \
     src/block/TrailerModel.cpp \
+    src/gui/BlockProfiler.cpp \
     src/gui/CameraToolbar.cpp \
+    src/gui/ConfigLoader.cpp \
+    src/gui/ExecutionPlan.cpp \
     src/gui/GuidanceToolbar.cpp \
     src/gui/GuidanceTurning.cpp \
+    src/gui/HeadlessRunner.cpp \
     src/gui/ImplementBlockModel.cpp \
     src/gui/ImplementSectionModel.cpp \
     src/gui/NumberBlockModel.cpp \
@@ -98,6 +105,8 @@ HEADERS += \
     src/block/GuidanceXte.h \
     src/block/Implement.h \
     src/block/ImplementSection.h \
+    src/block/LatencyDockBlock.h \
+    src/block/NmeaParserBase.h \
     src/block/NmeaParserGGA.h \
     src/block/NmeaParserHDT.h \
     src/block/NmeaParserRMC.h \
@@ -107,6 +116,7 @@ HEADERS += \
     src/block/PoseSynchroniser.h \
     src/block/PositionDockBlock.h \
     src/block/PrintLatency.h \
+    src/block/RawStreamRecorder.h \
     src/block/SprayerModel.h \
     src/block/StringObject.h \
     src/block/TractorModel.h \
@@ -118,17 +128,22 @@ HEADERS += \
     src/block/ValueDockBlockBase.h \
     src/block/ValueTransmissionBase.h \
     src/block/ValueTransmissionBase64Data.h \
+    src/block/ValueTransmissionDemux.h \
     src/block/ValueTransmissionNumber.h \
     src/block/ValueTransmissionQuaternion.h \
     src/block/ValueTransmissionState.h \
     src/block/VectorObject.h \
     src/block/XteDockBlock.h \
+    src/gui/BlockProfiler.h \
     src/gui/CameraToolbar.h \
+    src/gui/ConfigLoader.h \
+    src/gui/ExecutionPlan.h \
     src/gui/FieldsOptimitionToolbar.h \
     src/gui/FieldsToolbar.h \
     src/gui/FontComboboxDelegate.h \
     src/gui/GuidanceToolbar.h \
     src/gui/GuidanceTurning.h \
+    src/gui/HeadlessRunner.h \
     src/gui/ImplementBlockModel.h \
     src/gui/ImplementSectionModel.h \
     src/gui/MyFrameworkWidgetFactory.h \
@@ -145,12 +160,23 @@ HEADERS += \
     src/gui/ValueDock.h \
     src/gui/VectorBlockModel.h \
     src/gui/XteDock.h \
+    src/helpers/CborEncoder.h \
+    src/helpers/DatagramBatchReceiver.h \
+    src/helpers/IoDeviceThread.h \
+    src/helpers/LatencyHistogram.h \
+    src/helpers/NmeaTokenizer.h \
+    src/helpers/RawStreamFormat.h \
+    src/helpers/SimulationClock.h \
+    src/helpers/SpscRingBuffer.h \
+    src/helpers/UbxFramer.h \
     src/kinematic/CgalWorker.h \
     src/kinematic/FixedKinematic.h \
     src/kinematic/GeographicConvertionWrapper.h \
     src/kinematic/PathPrimitive.h \
     src/kinematic/Plan.h \
+    src/kinematic/Pose.h \
     src/kinematic/PoseOptions.h \
+    src/kinematic/SegmentIndex.h \
     src/kinematic/TrailerKinematic.h
 
 PRECOMPILED_HEADER  = src/pch.h
@@ -190,7 +216,6 @@ RESOURCES += \
 include($$PWD/src/qnodeseditor/qnodeeditor.pri)
 include($$PWD/lib/geographiclib.pri)
 include($$PWD/lib/cgal.pri)
-include($$PWD/lib/UBX_Parser.pri)
 
 # KDDockWidgets
 INCLUDEPATH += $$KDDOCKWIDGET_INCLUDE
@@ -234,4 +259,5 @@ SOURCES += \
     src/3d/3d-moc.cpp \
     src/block/block-moc.cpp \
     src/gui/gui-moc.cpp \
+    src/helpers/helpers-moc.cpp \
     src/kinematic/kinematic-moc.cpp
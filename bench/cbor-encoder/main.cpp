@@ -0,0 +1,183 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+// bytes and ns per message of the value transmission frames: the compact format (pre-encoded header of the
+// channel + the payload appended with CborEncoder, as ValueTransmissionBase does) compared to the legacy
+// format (a QCborMap with text keys encoded with toCbor()). Decoding with QCborValue::fromCbor() is measured
+// for both, as the demultiplexer does it.
+// The blocks need QtWidgets and Qt3D, so the encoding of ValueTransmissionBase is repeated here; keep the keys
+// in sync with it
+
+#include <QByteArray>
+#include <QCborMap>
+#include <QCborValue>
+#include <QString>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+
+#include "helpers/CborEncoder.h"
+
+namespace {
+  enum FrameKey : qint64 {
+    ChannelIdKey = 0,
+    PayloadKey = 1,
+    FormatKey = 2
+  };
+
+  constexpr qint64 FormatVersion = 1;
+  constexpr int ChannelId = 1234;
+  constexpr int NumMessages = 100000;
+
+  QByteArray frameHeader() {
+    QByteArray header;
+    CborEncoder::appendMapHeader( header, 3 );
+    CborEncoder::appendInteger( header, ChannelIdKey );
+    CborEncoder::appendInteger( header, ChannelId );
+    CborEncoder::appendInteger( header, FormatKey );
+    CborEncoder::appendInteger( header, FormatVersion );
+    CborEncoder::appendInteger( header, PayloadKey );
+    return header;
+  }
+
+  // best of some runs, in ns per message
+  double measure( const std::function<void( int )>& function ) {
+    double best = 1e300;
+
+    for( int run = 0; run < 5; ++run ) {
+      const auto start = std::chrono::steady_clock::now();
+
+      for( int i = 0; i < NumMessages; ++i ) {
+        function( i );
+      }
+
+      const auto end = std::chrono::steady_clock::now();
+      best = std::min( best, double( std::chrono::duration_cast<std::chrono::nanoseconds>( end - start ).count() ) / NumMessages );
+    }
+
+    return best;
+  }
+
+  struct Message {
+    const char* name;
+    std::function<QByteArray( const QByteArray&, int )> encodeCompact;
+    std::function<QByteArray( int )> encodeLegacy;
+  };
+}
+
+int main() {
+  const QByteArray header = frameHeader();
+  const QByteArray data( 64, 'x' );
+
+  const Message messages[] = {
+    { "Number", []( const QByteArray & header, int i ) {
+        QByteArray frame;
+        frame.reserve( header.size() + 9 );
+        frame.append( header );
+        CborEncoder::appendDouble( frame, i * 0.001 );
+        return frame;
+      }, []( int i ) {
+        QCborMap map;
+        map[QStringLiteral( "number" )] = i * 0.001;
+        map[QStringLiteral( "channelId" )] = ChannelId;
+        return map.toCborValue().toCbor();
+      }
+    },
+    { "State", []( const QByteArray & header, int i ) {
+        QByteArray frame;
+        frame.reserve( header.size() + 1 );
+        frame.append( header );
+        CborEncoder::appendBool( frame, ( i & 1 ) != 0 );
+        return frame;
+      }, []( int i ) {
+        QCborMap map;
+        map[QStringLiteral( "state" )] = ( i & 1 ) != 0;
+        map[QStringLiteral( "channelId" )] = ChannelId;
+        return map.toCborValue().toCbor();
+      }
+    },
+    { "Quaternion", []( const QByteArray & header, int i ) {
+        QByteArray frame;
+        frame.reserve( header.size() + 1 + 4 * 5 );
+        frame.append( header );
+        CborEncoder::appendArrayHeader( frame, 4 );
+        CborEncoder::appendFloat( frame, 1 );
+        CborEncoder::appendFloat( frame, i * 0.001f );
+        CborEncoder::appendFloat( frame, 0.5f );
+        CborEncoder::appendFloat( frame, 0.25f );
+        return frame;
+      }, []( int i ) {
+        QCborMap map;
+        map[QStringLiteral( "x" )] = i * 0.001f;
+        map[QStringLiteral( "y" )] = 0.5f;
+        map[QStringLiteral( "z" )] = 0.25f;
+        map[QStringLiteral( "w" )] = 1.f;
+        map[QStringLiteral( "channelId" )] = ChannelId;
+        return map.toCborValue().toCbor();
+      }
+    },
+    { "Data (64 bytes)", [&data]( const QByteArray & header, int ) {
+        QByteArray frame;
+        frame.reserve( header.size() + data.size() + 9 );
+        frame.append( header );
+        CborEncoder::appendByteString( frame, data );
+        return frame;
+      }, [&data]( int ) {
+        QCborMap map;
+        map[QStringLiteral( "data" )] = QString( data.toBase64( QByteArray::OmitTrailingEquals ) );
+        map[QStringLiteral( "channelId" )] = ChannelId;
+        return map.toCborValue().toCbor();
+      }
+    },
+  };
+
+  std::printf( "%-16s %14s %14s %14s %14s %14s %14s\n", "message",
+               "compact bytes", "legacy bytes",
+               "compact enc ns", "legacy enc ns",
+               "compact dec ns", "legacy dec ns" );
+
+  // keeps the compiler from dropping the work
+  qint64 sink = 0;
+
+  for( const auto& message : messages ) {
+    const QByteArray compactFrame = message.encodeCompact( header, 1 );
+    const QByteArray legacyFrame = message.encodeLegacy( 1 );
+
+    const double nsEncodeCompact = measure( [&]( int i ) {
+      sink += message.encodeCompact( header, i ).size();
+    } );
+    const double nsEncodeLegacy = measure( [&]( int i ) {
+      sink += message.encodeLegacy( i ).size();
+    } );
+    const double nsDecodeCompact = measure( [&]( int ) {
+      sink += QCborValue::fromCbor( compactFrame ).toMap().size();
+    } );
+    const double nsDecodeLegacy = measure( [&]( int ) {
+      sink += QCborValue::fromCbor( legacyFrame ).toMap().size();
+    } );
+
+    std::printf( "%-16s %14d %14d %14.1f %14.1f %14.1f %14.1f\n", message.name,
+                 compactFrame.size(), legacyFrame.size(),
+                 nsEncodeCompact, nsEncodeLegacy,
+                 nsDecodeCompact, nsDecodeLegacy );
+  }
+
+  return sink == 0 ? 1 : 0;
+}
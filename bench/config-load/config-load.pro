@@ -0,0 +1,43 @@
+# Copyright( C ) 2020 Christian Riggenbach
+#
+# This program is free software:
+# you can redistribute it and / or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# ( at your option ) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+#      but WITHOUT ANY WARRANTY;
+# without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+include(../bench.pri)
+
+# the blocks live in a QGraphicsScene and BlockBase.h includes Qt3D
+QT += gui widgets 3dcore
+
+INCLUDEPATH += $$PWD/../../src/qnodeseditor
+
+TARGET = bench-config-load
+
+SOURCES += \
+    main.cpp \
+    $$PWD/../../src/gui/ConfigLoader.cpp \
+    $$PWD/../../src/qnodeseditor/qneblock.cpp \
+    $$PWD/../../src/qnodeseditor/qneport.cpp \
+    $$PWD/../../src/qnodeseditor/qneconnection.cpp \
+    $$PWD/../../src/qnodeseditor/qneconnectionrelay.cpp
+
+HEADERS += \
+    $$PWD/../../src/block/BlockBase.h \
+    $$PWD/../../src/gui/ConfigLoader.h \
+    $$PWD/../../src/helpers/SimulationClock.h \
+    $$PWD/../../src/qnodeseditor/qneblock.h \
+    $$PWD/../../src/qnodeseditor/qneport.h \
+    $$PWD/../../src/qnodeseditor/qneconnection.h \
+    $$PWD/../../src/qnodeseditor/qneconnectionrelay.h
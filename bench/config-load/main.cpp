@@ -0,0 +1,287 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+// load benchmark of the block index: a config with 1000 blocks and 3000 connections is loaded with ConfigLoader,
+// then the lookups of the loading are done again, through the per-scene index of QNEBlock and the port hashes,
+// and by walking the scene and the ports of the blocks, as ConfigLoader and QNEBlock did before the index
+
+#include <QApplication>
+#include <QGraphicsScene>
+#include <QJsonArray>
+#include <QJsonObject>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+#include "block/BlockBase.h"
+#include "gui/ConfigLoader.h"
+#include "qnodeseditor/qneblock.h"
+#include "qnodeseditor/qneport.h"
+
+class BenchBlock : public BlockBase {
+    Q_OBJECT
+
+  public:
+    BenchBlock() : BlockBase() {}
+
+  public slots:
+    void setNumber1( double ) {}
+    void setNumber2( double ) {}
+    void setNumber3( double ) {}
+
+  signals:
+    void numberChanged1( double );
+    void numberChanged2( double );
+    void numberChanged3( double );
+};
+
+class BenchBlockFactory : public BlockFactory {
+    Q_OBJECT
+
+  public:
+    BenchBlockFactory() : BlockFactory() {}
+
+    QString getNameOfFactory() override {
+      return QStringLiteral( "Bench Block" );
+    }
+
+    virtual void addToCombobox( QComboBox* combobox ) override {
+      combobox->addItem( getNameOfFactory(), QVariant::fromValue( this ) );
+    }
+
+    virtual QNEBlock* createBlock( QGraphicsScene* scene, int id ) override {
+      auto* obj = new BenchBlock();
+      auto* b = createBaseBlock( scene, obj, id );
+
+      b->addInputPort( QStringLiteral( "Number 1" ), QLatin1String( SLOT( setNumber1( double ) ) ) );
+      b->addInputPort( QStringLiteral( "Number 2" ), QLatin1String( SLOT( setNumber2( double ) ) ) );
+      b->addInputPort( QStringLiteral( "Number 3" ), QLatin1String( SLOT( setNumber3( double ) ) ) );
+
+      b->addOutputPort( QStringLiteral( "Number 1" ), QLatin1String( SIGNAL( numberChanged1( double ) ) ) );
+      b->addOutputPort( QStringLiteral( "Number 2" ), QLatin1String( SIGNAL( numberChanged2( double ) ) ) );
+      b->addOutputPort( QStringLiteral( "Number 3" ), QLatin1String( SIGNAL( numberChanged3( double ) ) ) );
+
+      return b;
+    }
+};
+
+constexpr int numBlocks = 1000;
+constexpr int portsPerBlock = 3;
+
+// every output of every block goes to another block, so there are three connections per block
+static QJsonObject createConfig() {
+  QJsonArray blocks;
+
+  for( int i = 0; i < numBlocks; ++i ) {
+    QJsonObject block;
+    block[QStringLiteral( "id" )] = int( QNEBlock::IdRange::UserIdStart ) + i;
+    block[QStringLiteral( "name" )] = QStringLiteral( "Block %1" ).arg( i );
+    block[QStringLiteral( "type" )] = QStringLiteral( "Bench Block" );
+    block[QStringLiteral( "positionX" )] = 0;
+    block[QStringLiteral( "positionY" )] = 0;
+    blocks.append( block );
+  }
+
+  QJsonArray connections;
+
+  for( int i = 0; i < numBlocks; ++i ) {
+    for( int port = 1; port <= portsPerBlock; ++port ) {
+      QJsonObject connection;
+      connection[QStringLiteral( "idFrom" )] = int( QNEBlock::IdRange::UserIdStart ) + i;
+      connection[QStringLiteral( "idTo" )] = int( QNEBlock::IdRange::UserIdStart ) + ( i + 1 + port * 7 ) % numBlocks;
+      connection[QStringLiteral( "portFrom" )] = QStringLiteral( "Number %1" ).arg( port );
+      connection[QStringLiteral( "portTo" )] = QStringLiteral( "Number %1" ).arg( port );
+      connections.append( connection );
+    }
+  }
+
+  QJsonObject json;
+  json[QStringLiteral( "blocks" )] = blocks;
+  json[QStringLiteral( "connections" )] = connections;
+  return json;
+}
+
+// the lookups before the index
+static QNEBlock* getBlockWithIdByScan( const QGraphicsScene* scene, int id ) {
+  const auto& constRefOfList = scene->items();
+
+  for( const auto& item : constRefOfList ) {
+    auto* block = qgraphicsitem_cast<QNEBlock*>( item );
+
+    if( block != nullptr && block->id == id ) {
+      return block;
+    }
+  }
+
+  return nullptr;
+}
+
+static QNEBlock* getBlockWithNameByScan( const QGraphicsScene* scene, const QString& name ) {
+  const auto& constRefOfList = scene->items();
+
+  for( const auto& item : constRefOfList ) {
+    auto* block = qgraphicsitem_cast<QNEBlock*>( item );
+
+    if( block != nullptr && block->getName() == name ) {
+      return block;
+    }
+  }
+
+  return nullptr;
+}
+
+static QNEPort* getPortWithNameByScan( const QNEBlock* block, const QString& name, bool output ) {
+  const auto& constRefOfList = block->childItems();
+
+  for( const auto& item : constRefOfList ) {
+    auto* port = qgraphicsitem_cast<QNEPort*>( item );
+
+    if( ( port != nullptr ) &&
+        ( ( port->portFlags() & ( QNEPort::NamePort | QNEPort::TypePort ) ) == 0 ) &&
+        port->isOutput() == output &&
+        port->getName() == name ) {
+      return port;
+    }
+  }
+
+  return nullptr;
+}
+
+// best of some runs, in µs
+static double measure( const int runs, const std::function<void()>& run ) {
+  double best = 1e300;
+
+  for( int i = 0; i < runs; ++i ) {
+    const auto start = std::chrono::steady_clock::now();
+    run();
+    const auto end = std::chrono::steady_clock::now();
+
+    best = std::min( best, double( std::chrono::duration_cast<std::chrono::nanoseconds>( end - start ).count() ) / 1000 );
+  }
+
+  return best;
+}
+
+struct Lookup {
+  int idFrom;
+  int idTo;
+  QString name;
+  QString portName;
+};
+
+// the lookups ConfigLoader does for the config: a block by name, two blocks by id and two ports per connection
+static quintptr lookUp( const QGraphicsScene* scene, const std::vector<Lookup>& lookups, bool withIndex ) {
+  quintptr sink = 0;
+
+  for( const auto& lookup : lookups ) {
+    QNEBlock* block = withIndex ? QNEBlock::getBlockWithName( scene, lookup.name ) : getBlockWithNameByScan( scene, lookup.name );
+    QNEBlock* blockFrom = withIndex ? QNEBlock::getBlockWithId( scene, lookup.idFrom ) : getBlockWithIdByScan( scene, lookup.idFrom );
+    QNEBlock* blockTo = withIndex ? QNEBlock::getBlockWithId( scene, lookup.idTo ) : getBlockWithIdByScan( scene, lookup.idTo );
+
+    if( block == nullptr || blockFrom == nullptr || blockTo == nullptr ) {
+      return 0;
+    }
+
+    QNEPort* portFrom = withIndex ? blockFrom->getPortWithName( lookup.portName, true ) : getPortWithNameByScan( blockFrom, lookup.portName, true );
+    QNEPort* portTo = withIndex ? blockTo->getPortWithName( lookup.portName, false ) : getPortWithNameByScan( blockTo, lookup.portName, false );
+
+    if( portFrom == nullptr || portTo == nullptr ) {
+      return 0;
+    }
+
+    sink += quintptr( block ) ^ quintptr( blockFrom ) ^ quintptr( blockTo ) ^ quintptr( portFrom ) ^ quintptr( portTo );
+  }
+
+  return sink;
+}
+
+int main( int argc, char** argv ) {
+  // the scene needs a QApplication, but no display
+  if( !qEnvironmentVariableIsSet( "QT_QPA_PLATFORM" ) ) {
+    qputenv( "QT_QPA_PLATFORM", "offscreen" );
+  }
+
+  QApplication app( argc, argv );
+
+  BenchBlockFactory factory;
+  const QJsonObject config = createConfig();
+
+  // loading; every run into a new scene, as the ids have to be free. They are deleted after the measurement
+  std::vector<QGraphicsScene*> scenes;
+  const double usLoad = measure( 5, [&] {
+    auto* scene = new QGraphicsScene();
+    scenes.push_back( scene );
+
+    ConfigLoader loader( scene, [&factory]( const QString & ) {
+      return &factory;
+    } );
+    loader.selectLoadedItems = false;
+    loader.load( config );
+  } );
+
+  for( auto* scene : scenes ) {
+    delete scene;
+  }
+
+  QCoreApplication::sendPostedEvents( nullptr, QEvent::DeferredDelete );
+
+  // the lookups of the loading in a loaded scene
+  QGraphicsScene scene;
+  ConfigLoader loader( &scene, [&factory]( const QString & ) {
+    return &factory;
+  } );
+  loader.selectLoadedItems = false;
+  loader.load( config );
+
+  std::vector<Lookup> lookups;
+  const QJsonArray connections = config[QStringLiteral( "connections" )].toArray();
+
+  for( const auto& connection : connections ) {
+    const QJsonObject connectionObject = connection.toObject();
+    const int idFrom = connectionObject[QStringLiteral( "idFrom" )].toInt();
+
+    lookups.push_back( { idFrom,
+                         connectionObject[QStringLiteral( "idTo" )].toInt(),
+                         QStringLiteral( "Block %1" ).arg( idFrom - int( QNEBlock::IdRange::UserIdStart ) ),
+                         connectionObject[QStringLiteral( "portFrom" )].toString() } );
+  }
+
+  quintptr sinkIndex = 0;
+  quintptr sinkScan = 0;
+  const double usIndex = measure( 10, [&] { sinkIndex = lookUp( &scene, lookups, true ); } );
+  const double usScan = measure( 3, [&] { sinkScan = lookUp( &scene, lookups, false ); } );
+
+  std::printf( "%d blocks, %d connections\n", numBlocks, int( lookups.size() ) );
+  std::printf( "load with ConfigLoader:  %10.1f ms\n", usLoad / 1000 );
+  std::printf( "lookups with the index:  %10.1f ms (%.3f us/connection)\n", usIndex / 1000, usIndex / lookups.size() );
+  std::printf( "lookups by walking:      %10.1f ms (%.3f us/connection)\n", usScan / 1000, usScan / lookups.size() );
+  std::printf( "speedup of the lookups:  %10.1fx\n", usScan / usIndex );
+
+  // both have to find the same blocks and ports, else the comparison is meaningless
+  if( sinkIndex == 0 || sinkIndex != sinkScan ) {
+    std::printf( "lookups differ\n" );
+    return 1;
+  }
+
+  return 0;
+}
+
+#include "main.moc"
@@ -0,0 +1,147 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+// benchmark of Plan::indexOfNearestParallelLine(): ns per pose for a plan of 10000 AB lines, made like
+// GlobalPlannerLines does, compared to the scan through the lines, that XteGuidance and LocalPlanner still use
+// for plans without the parallel-lines description. Both have to find lines at the same distance
+
+#include <QtGlobal>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "cgalKernel.h"
+#include "kinematic/PathPrimitive.h"
+#include "kinematic/Plan.h"
+
+// best of some runs, in ns per pose
+static double measure( const int runs, const int numPoses, const std::function<void()>& run ) {
+  double best = 1e300;
+
+  for( int i = 0; i < runs; ++i ) {
+    const auto start = std::chrono::steady_clock::now();
+    run();
+    const auto end = std::chrono::steady_clock::now();
+
+    best = std::min( best, double( std::chrono::duration_cast<std::chrono::nanoseconds>( end - start ).count() ) / numPoses );
+  }
+
+  return best;
+}
+
+// the scan of XteGuidance
+static const PathPrimitiveLine* nearestLineByScan( const Plan& plan, const Point_2& position2D ) {
+  double distanceSquared = qInf();
+  const PathPrimitiveLine* nearestLine = nullptr;
+
+  for( const auto& pathPrimitive : *plan.plan ) {
+    const auto* line = boost::get<PathPrimitiveLine>( &pathPrimitive );
+    double currentDistanceSquared = CGAL::squared_distance( line->line, position2D );
+
+    if( currentDistanceSquared < distanceSquared ) {
+      nearestLine = line;
+      distanceSquared = currentDistanceSquared;
+    } else {
+      // the plan is ordered, so we can take the fast way out...
+      break;
+    }
+  }
+
+  return nearestLine;
+}
+
+int main() {
+  constexpr int numPasses = 10000;
+  constexpr double implementWidth = 6;
+
+  // the passes of an AB line, sorted from right to left like GlobalPlannerLines::createPlanAB()
+  const Segment_2 ab2dSegment( Point_2( 10, 20 ), Point_2( 110, 70 ) );
+  const double angleAbRad = angleOfLineRadians( ab2dSegment.supporting_line() );
+  const int32_t firstPass = -numPasses / 2;
+
+  std::vector<PathPrimitive> passes;
+
+  for( int32_t pass = firstPass + numPasses - 1; pass >= firstPass; --pass ) {
+    auto offsetVector = polarOffset( M_PI + angleAbRad, pass * implementWidth );
+    passes.emplace_back( PathPrimitiveLine( Line_2( ab2dSegment.source() - offsetVector, ab2dSegment.target() - offsetVector ),
+                                            implementWidth, true, pass ) );
+  }
+
+  Plan plan( Plan::Type::OnlyLines, std::move( passes ) );
+  plan.setParallelLines( boost::get<PathPrimitiveLine>( plan.plan->front() ).line, polarOffset( M_PI + angleAbRad, implementWidth ) );
+
+  // 200 s of poses at 100 Hz, spread over the whole plan and a bit beyond, along the AB line and across it
+  constexpr int numPoses = 20000;
+  std::mt19937 generator( 42 );
+  std::uniform_real_distribution<double> along( -500, 500 );
+  std::uniform_real_distribution<double> across( ( firstPass - 10 ) * implementWidth, ( firstPass + numPasses + 10 ) * implementWidth );
+
+  const Vector_2 directionAb = ab2dSegment.to_vector() / std::sqrt( ab2dSegment.squared_length() );
+  const Vector_2 directionAcross = polarOffset( M_PI + angleAbRad, 1 );
+
+  std::vector<Point_2> poses;
+  poses.reserve( numPoses );
+
+  for( int i = 0; i < numPoses; ++i ) {
+    poses.push_back( ab2dSegment.source() + directionAb * along( generator ) - directionAcross * across( generator ) );
+  }
+
+  std::vector<const PathPrimitiveLine*> linesByIndex( numPoses, nullptr );
+  std::vector<const PathPrimitiveLine*> linesByScan( numPoses, nullptr );
+
+  const double nsIndex = measure( 10, numPoses, [&] {
+    for( int i = 0; i < numPoses; ++i ) {
+      linesByIndex[i] = boost::get<PathPrimitiveLine>( &plan.plan->at( size_t( plan.indexOfNearestParallelLine( poses[i] ) ) ) );
+    }
+  } );
+
+  const double nsScan = measure( 3, numPoses, [&] {
+    for( int i = 0; i < numPoses; ++i ) {
+      linesByScan[i] = nearestLineByScan( plan, poses[i] );
+    }
+  } );
+
+  std::printf( "%d lines, %d poses\n", numPasses, numPoses );
+  std::printf( "indexOfNearestParallelLine(): %12.1f ns/pose\n", nsIndex );
+  std::printf( "scan through the lines:       %12.1f ns/pose\n", nsScan );
+  std::printf( "speedup:                      %12.1fx\n", nsScan / nsIndex );
+  std::printf( "at 100 Hz: %.1f us/s with the index, %.1f us/s with the scan\n", nsIndex * 100 / 1000, nsScan * 100 / 1000 );
+
+  // the same line or, right between two lines, one at the same distance
+  int differences = 0;
+
+  for( int i = 0; i < numPoses; ++i ) {
+    const double distanceByIndex = CGAL::squared_distance( linesByIndex[i]->line, poses[i] );
+    const double distanceByScan = CGAL::squared_distance( linesByScan[i]->line, poses[i] );
+
+    if( linesByIndex[i] != linesByScan[i] && qAbs( distanceByIndex - distanceByScan ) > 1e-6 ) {
+      ++differences;
+    }
+  }
+
+  if( differences != 0 ) {
+    std::printf( "%d poses with a different nearest line\n", differences );
+    return 1;
+  }
+
+  return 0;
+}
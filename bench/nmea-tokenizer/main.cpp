@@ -0,0 +1,158 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+// parse benchmark of NmeaTokenizer: ns per sentence for a mix of GGA, RMC and HDT sentences, compared to
+// splitting the line into a QStringList and converting the fields with QString::toDouble(), as the parsers did
+// before the tokenizer
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <QTextStream>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+
+#include "helpers/NmeaTokenizer.h"
+
+static QByteArray sentenceWithChecksum( const QByteArray& body ) {
+  quint8 checksum = 0;
+
+  for( const char c : body ) {
+    checksum ^= quint8( c );
+  }
+
+  return "$" + body + "*" + QByteArray::number( checksum, 16 ).toUpper().rightJustified( 2, '0' ) + "\r\n";
+}
+
+// best of some runs, in ns per sentence
+static double measure( const int numSentences, const std::function<double()>& run, double& result ) {
+  double best = 1e300;
+
+  for( int i = 0; i < 10; ++i ) {
+    const auto start = std::chrono::steady_clock::now();
+    result = run();
+    const auto end = std::chrono::steady_clock::now();
+
+    best = std::min( best, double( std::chrono::duration_cast<std::chrono::nanoseconds>( end - start ).count() ) / numSentences );
+  }
+
+  return best;
+}
+
+static double parseWithTokenizer( const QByteArray& buffer ) {
+  double sum = 0;
+  const char* lineBegin = nullptr;
+  const char* lineEnd = nullptr;
+  NmeaSentence sentence;
+
+  for( int position = 0; ( position = NmeaTokenizer::nextLine( buffer, position, lineBegin, lineEnd ) ) >= 0; ) {
+    if( sentence.parse( lineBegin, lineEnd ) != NmeaSentence::Status::Valid ) {
+      continue;
+    }
+
+    double value = 0;
+
+    if( sentence.isType( "GGA" ) ) {
+      if( sentence.field( 2 ).toDegrees( 2, value ) ) {
+        sum += value;
+      }
+
+      if( sentence.field( 4 ).toDegrees( 3, value ) ) {
+        sum += value;
+      }
+
+      sum += sentence.field( 9 ).toDouble();
+    } else if( sentence.isType( "RMC" ) ) {
+      sum += sentence.field( 7 ).toDouble();
+      sum += sentence.field( 8 ).toDouble();
+    } else if( sentence.isType( "HDT" ) ) {
+      sum += sentence.field( 1 ).toDouble();
+    }
+  }
+
+  return sum;
+}
+
+static double parseWithStringList( const QByteArray& buffer ) {
+  double sum = 0;
+  QTextStream textstream( buffer, QIODevice::ReadOnly );
+  QString currentLine;
+
+  while( textstream.readLineInto( &currentLine ) ) {
+    quint8 checksum = 0;
+    int indexOfChecksum = currentLine.indexOf( '*' );
+
+    for( int i = 1; i < indexOfChecksum; ++i ) {
+      checksum ^= quint8( currentLine.at( i ).toLatin1() );
+    }
+
+    if( indexOfChecksum < 0 || checksum != currentLine.midRef( indexOfChecksum + 1, 2 ).toUInt( nullptr, 16 ) ) {
+      continue;
+    }
+
+    currentLine.truncate( indexOfChecksum );
+    QStringList nmeaFields = currentLine.split( ',' );
+    nmeaFields.first().remove( 0, 3 );
+
+    if( nmeaFields.front() == QStringLiteral( "GGA" ) ) {
+      sum += nmeaFields[2].leftRef( 2 ).toDouble() + nmeaFields[2].midRef( 2 ).toDouble() / 60;
+      sum += nmeaFields[4].leftRef( 3 ).toDouble() + nmeaFields[4].midRef( 3 ).toDouble() / 60;
+      sum += nmeaFields[9].toDouble();
+    } else if( nmeaFields.front() == QStringLiteral( "RMC" ) ) {
+      sum += nmeaFields[7].toDouble();
+      sum += nmeaFields[8].toDouble();
+    } else if( nmeaFields.front() == QStringLiteral( "HDT" ) ) {
+      sum += nmeaFields[1].toDouble();
+    }
+  }
+
+  return sum;
+}
+
+int main() {
+  const QByteArray gga = sentenceWithChecksum( "GNGGA,092725.00,4717.11399,N,00833.91590,E,1,08,1.01,499.6,M,48.0,M,," );
+  const QByteArray rmc = sentenceWithChecksum( "GNRMC,083559.00,A,4717.11437,N,00833.91522,E,0.004,77.52,091202,,,A" );
+  const QByteArray hdt = sentenceWithChecksum( "GNHDT,123.456,T" );
+
+  constexpr int numSentences = 30000;
+  QByteArray buffer;
+
+  for( int i = 0; i < numSentences / 3; ++i ) {
+    buffer += gga + rmc + hdt;
+  }
+
+  double resultOfTokenizer = 0;
+  double resultOfStringList = 0;
+  const double nsTokenizer = measure( numSentences, [&buffer] { return parseWithTokenizer( buffer ); }, resultOfTokenizer );
+  const double nsStringList = measure( numSentences, [&buffer] { return parseWithStringList( buffer ); }, resultOfStringList );
+
+  std::printf( "NmeaTokenizer:          %8.1f ns/sentence\n", nsTokenizer );
+  std::printf( "QStringList + toDouble: %8.1f ns/sentence\n", nsStringList );
+  std::printf( "speedup:                %8.1fx\n", nsStringList / nsTokenizer );
+
+  // both have to see the same values, else the comparison is meaningless
+  if( qAbs( resultOfTokenizer - resultOfStringList ) > 1e-6 * qAbs( resultOfStringList ) ) {
+    std::printf( "results differ: %f %f\n", resultOfTokenizer, resultOfStringList );
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,173 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+// benchmark of SegmentIndex: us per fix for a plan of 50000 segments in a few curved chains, like curved AB lines
+// and contours, followed by a vehicle driving at 100 Hz. Compared to measuring the distance to every segment, the
+// brute-force search; both have to find segments at the same distance
+
+#include <QtGlobal>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "cgalKernel.h"
+#include "kinematic/PathPrimitive.h"
+#include "kinematic/Plan.h"
+#include "kinematic/SegmentIndex.h"
+
+// best of some runs, in us per fix
+static double measure( const int runs, const int numFixes, const std::function<void()>& run ) {
+  double best = 1e300;
+
+  for( int i = 0; i < runs; ++i ) {
+    const auto start = std::chrono::steady_clock::now();
+    run();
+    const auto end = std::chrono::steady_clock::now();
+
+    best = std::min( best, double( std::chrono::duration_cast<std::chrono::nanoseconds>( end - start ).count() ) / 1000 / numFixes );
+  }
+
+  return best;
+}
+
+static int nearestSegmentByBruteForce( const Plan& plan, const Point_2& point ) {
+  int nearest = -1;
+  double nearestDistanceSquared = qInf();
+
+  for( size_t index = 0; index < plan.plan->size(); ++index ) {
+    if( const auto* pathSegment = boost::get<PathPrimitiveSegment>( &( *plan.plan )[index] ) ) {
+      const double distanceSquared = CGAL::squared_distance( pathSegment->segment, point );
+
+      if( distanceSquared < nearestDistanceSquared ) {
+        nearest = int( index );
+        nearestDistanceSquared = distanceSquared;
+      }
+    }
+  }
+
+  return nearest;
+}
+
+static double distanceSquaredToSegment( const Plan& plan, const int index, const Point_2& point ) {
+  return CGAL::squared_distance( boost::get<PathPrimitiveSegment>( plan.plan->at( size_t( index ) ) ).segment, point );
+}
+
+int main() {
+  constexpr int numSegments = 50000;
+  constexpr int numChains = 10;
+
+  std::mt19937 generator( 42 );
+  std::uniform_real_distribution<double> uniform( 0, 1 );
+
+  // chains of segments from 0.5 to 2 m, slowly turning, in a field of 1 km x 1 km
+  std::vector<PathPrimitive> segments;
+  segments.reserve( numSegments );
+
+  for( int chain = 0; chain < numChains; ++chain ) {
+    double x = uniform( generator ) * 1000;
+    double y = uniform( generator ) * 1000;
+    double heading = uniform( generator ) * 2 * M_PI;
+
+    for( int i = 0; i < numSegments / numChains; ++i ) {
+      heading += ( uniform( generator ) - 0.5 ) * 0.2;
+      const double length = 0.5 + uniform( generator ) * 1.5;
+      const double nextX = x + length * std::cos( heading );
+      const double nextY = y + length * std::sin( heading );
+
+      segments.emplace_back( PathPrimitiveSegment( Segment_2( Point_2( x, y ), Point_2( nextX, nextY ) ), 3, true, chain ) );
+
+      x = nextX;
+      y = nextY;
+    }
+  }
+
+  const Plan plan( Plan::Type::OnlySegments, std::move( segments ) );
+
+  // 100 s at 100 Hz and 10 m/s, starting anew at a random place every 10 s
+  constexpr int numFixes = 10000;
+  std::vector<Point_2> fixes;
+  fixes.reserve( numFixes );
+
+  {
+    double x = 0;
+    double y = 0;
+    double heading = 0;
+
+    for( int i = 0; i < numFixes; ++i ) {
+      if( i % 1000 == 0 ) {
+        x = uniform( generator ) * 1200 - 100;
+        y = uniform( generator ) * 1200 - 100;
+      }
+
+      heading += ( uniform( generator ) - 0.5 ) * 0.1;
+      x += 0.1 * std::cos( heading );
+      y += 0.1 * std::sin( heading );
+      fixes.emplace_back( x, y );
+    }
+  }
+
+  SegmentIndex segmentIndex;
+
+  const auto startOfBuild = std::chrono::steady_clock::now();
+  segmentIndex.build( plan );
+  const auto endOfBuild = std::chrono::steady_clock::now();
+
+  std::vector<int> nearestByIndex( numFixes, -1 );
+  std::vector<int> nearestByBruteForce( numFixes, -1 );
+
+  const double usIndex = measure( 10, numFixes, [&] {
+    for( int i = 0; i < numFixes; ++i ) {
+      nearestByIndex[size_t( i )] = segmentIndex.nearestSegment( fixes[size_t( i )] );
+    }
+  } );
+
+  const double usBruteForce = measure( 1, numFixes, [&] {
+    for( int i = 0; i < numFixes; ++i ) {
+      nearestByBruteForce[size_t( i )] = nearestSegmentByBruteForce( plan, fixes[size_t( i )] );
+    }
+  } );
+
+  std::printf( "%d segments, %d fixes\n", numSegments, numFixes );
+  std::printf( "build of the index:  %10.1f ms\n", double( std::chrono::duration_cast<std::chrono::microseconds>( endOfBuild - startOfBuild ).count() ) / 1000 );
+  std::printf( "SegmentIndex:        %10.2f us/fix\n", usIndex );
+  std::printf( "brute force:         %10.2f us/fix\n", usBruteForce );
+  std::printf( "speedup:             %10.1fx\n", usBruteForce / usIndex );
+
+  // the same segment or one at the same distance, like the segments meeting at the nearest point of a chain
+  int differences = 0;
+
+  for( int i = 0; i < numFixes; ++i ) {
+    if( nearestByIndex[size_t( i )] < 0 ||
+        qAbs( distanceSquaredToSegment( plan, nearestByIndex[size_t( i )], fixes[size_t( i )] ) -
+              distanceSquaredToSegment( plan, nearestByBruteForce[size_t( i )], fixes[size_t( i )] ) ) > 1e-9 ) {
+      ++differences;
+    }
+  }
+
+  if( differences != 0 ) {
+    std::printf( "%d fixes with a different nearest segment\n", differences );
+    return 1;
+  }
+
+  return 0;
+}
@@ -1,5 +0,0 @@
-DEPENDPATH      += $$PWD/UBX_Parser
-
-INCLUDEPATH     += $$PWD/UBX_Parser/src
-
-HEADERS  += $$PWD/UBX_Parser/src/UBX_Parser.h
@@ -30,6 +30,10 @@ class AckermannSteering : public BlockBase {
   public:
     explicit AckermannSteering() = default;
 
+    bool canMoveToControlThread() const override {
+      return true;
+    }
+
   public slots:
     void setWheelbase( double wheelbase ) {
       m_wheelbase = wheelbase;
@@ -46,6 +46,17 @@ class BlockBase : public QObject {
     virtual void fromJSON( QJsonObject& ) {}
 
     virtual void setName( const QString& ) {}
+
+    // true for blocks without any GUI or 3D parts, so they can run on the control thread
+    virtual bool canMoveToControlThread() const {
+      return false;
+    }
+
+    // the value of a block that only sends a constant from the settings; invalid for all the others
+    // the connections from these blocks are folded when loading a config
+    virtual QVariant constantValue() const {
+      return QVariant();
+    }
 };
 
 class BlockFactory : public QObject {
@@ -78,18 +89,6 @@ class BlockFactory : public QObject {
     }
 
     bool isIdUnique( QGraphicsScene* scene, int id ) {
-      const auto& constRefOfList = scene->items();
-
-      for( const auto& item : constRefOfList ) {
-        auto* block = qgraphicsitem_cast<QNEBlock*>( item );
-
-        if( block != nullptr ) {
-          if( block->id == id ) {
-            return false;
-          }
-        }
-      }
-
-      return true;
+      return QNEBlock::getBlockWithId( scene, id ) == nullptr;
     }
 };
@@ -23,17 +23,34 @@
 
 #include "BlockBase.h"
 
+#include "../helpers/LatencyHistogram.h"
+
 class CommunicationJrk : public BlockBase {
     Q_OBJECT
 
   public:
     explicit CommunicationJrk()
       : BlockBase() {
+      ageOfData = new LatencyStatistics( this );
+      connect( ageOfData, &LatencyStatistics::latencyChanged, this, &CommunicationJrk::ageOfDataChanged );
+      connect( ageOfData, &LatencyStatistics::p50Changed, this, &CommunicationJrk::ageOfDataP50Changed );
+      connect( ageOfData, &LatencyStatistics::p99Changed, this, &CommunicationJrk::ageOfDataP99Changed );
+      connect( ageOfData, &LatencyStatistics::maxChanged, this, &CommunicationJrk::ageOfDataMaxChanged );
+    }
+
+    bool canMoveToControlThread() const override {
+      return true;
     }
 
   signals:
     void dataReceived( const QByteArray& );
 
+    // time from the reception of the GNSS data to the steering command in ms
+    void ageOfDataChanged( const double, const double, const double );
+    void ageOfDataP50Changed( const double );
+    void ageOfDataP99Changed( const double );
+    void ageOfDataMaxChanged( const double );
+
   public slots:
     void setSteeringAngle( double steeringAngle ) {
 
@@ -44,6 +61,7 @@ class CommunicationJrk : public BlockBase {
       data[0] = char( 0xc0 | ( target & 0x1f ) );
       data[1] = char( ( target >> 5 ) & 0x7f );
 
+      ageOfData->record();
       emit dataReceived( data );
     }
 
@@ -56,6 +74,8 @@ class CommunicationJrk : public BlockBase {
     }
 
   private:
+    LatencyStatistics* ageOfData = nullptr;
+
     float steerZero = 2047;
     float countsPerDegree = 45;
 };
@@ -83,6 +103,10 @@ class CommunicationJrkFactory : public BlockFactory {
       b->addInputPort( QStringLiteral( "Steering count/°" ), QLatin1String( SLOT( setSteerCountPerDegree( double ) ) ) );
       b->addInputPort( QStringLiteral( "Steering Angle" ), QLatin1String( SLOT( setSteeringAngle( double ) ) ) );
       b->addOutputPort( QStringLiteral( "Data" ), QLatin1String( SIGNAL( dataReceived( const QByteArray& ) ) ) );
+      b->addOutputPort( QStringLiteral( "Age of Data" ), QLatin1String( SIGNAL( ageOfDataChanged( const double, const double, const double ) ) ) );
+      b->addOutputPort( QStringLiteral( "Age of Data p50" ), QLatin1String( SIGNAL( ageOfDataP50Changed( const double ) ) ) );
+      b->addOutputPort( QStringLiteral( "Age of Data p99" ), QLatin1String( SIGNAL( ageOfDataP99Changed( const double ) ) ) );
+      b->addOutputPort( QStringLiteral( "Age of Data Max" ), QLatin1String( SIGNAL( ageOfDataMaxChanged( const double ) ) ) );
 
       b->setBrush( QColor( QStringLiteral( "mediumaquamarine" ) ) );
 
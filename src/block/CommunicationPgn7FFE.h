@@ -23,17 +23,34 @@
 
 #include "BlockBase.h"
 
+#include "../helpers/LatencyHistogram.h"
+
 class CommunicationPgn7ffe : public BlockBase {
     Q_OBJECT
 
   public:
     explicit CommunicationPgn7ffe()
       : BlockBase() {
+      ageOfData = new LatencyStatistics( this );
+      connect( ageOfData, &LatencyStatistics::latencyChanged, this, &CommunicationPgn7ffe::ageOfDataChanged );
+      connect( ageOfData, &LatencyStatistics::p50Changed, this, &CommunicationPgn7ffe::ageOfDataP50Changed );
+      connect( ageOfData, &LatencyStatistics::p99Changed, this, &CommunicationPgn7ffe::ageOfDataP99Changed );
+      connect( ageOfData, &LatencyStatistics::maxChanged, this, &CommunicationPgn7ffe::ageOfDataMaxChanged );
+    }
+
+    bool canMoveToControlThread() const override {
+      return true;
     }
 
   signals:
     void  dataReceived( const QByteArray& );
 
+    // age of the sent data in ms, measured from the reception of the sample, that caused it
+    void ageOfDataChanged( const double, const double, const double );
+    void ageOfDataP50Changed( const double );
+    void ageOfDataP99Changed( const double );
+    void ageOfDataMaxChanged( const double );
+
   public slots:
     void setSteeringAngle( double steeringAngle ) {
       QByteArray data;
@@ -57,6 +74,7 @@ class CommunicationPgn7ffe : public BlockBase {
       data[6] = char( steerangle >> 8 );
       data[7] = char( steerangle & 0xff );
 
+      ageOfData->record();
       emit dataReceived( data );
     }
 
@@ -69,6 +87,8 @@ class CommunicationPgn7ffe : public BlockBase {
     }
 
   private:
+    LatencyStatistics* ageOfData = nullptr;
+
     float distance = 0;
     float velocity = 0;
 };
@@ -96,6 +116,10 @@ class CommunicationPgn7ffeFactory : public BlockFactory {
       b->addInputPort( QStringLiteral( "Velocity" ), QLatin1String( SLOT( setVelocity( double ) ) ) );
       b->addInputPort( QStringLiteral( "XTE" ), QLatin1String( SLOT( setXte( double ) ) ) );
       b->addOutputPort( QStringLiteral( "Data" ), QLatin1String( SIGNAL( dataReceived( const QByteArray& ) ) ) );
+      b->addOutputPort( QStringLiteral( "Age of Data" ), QLatin1String( SIGNAL( ageOfDataChanged( const double, const double, const double ) ) ) );
+      b->addOutputPort( QStringLiteral( "Age of Data p50" ), QLatin1String( SIGNAL( ageOfDataP50Changed( const double ) ) ) );
+      b->addOutputPort( QStringLiteral( "Age of Data p99" ), QLatin1String( SIGNAL( ageOfDataP99Changed( const double ) ) ) );
+      b->addOutputPort( QStringLiteral( "Age of Data Max" ), QLatin1String( SIGNAL( ageOfDataMaxChanged( const double ) ) ) );
 
       b->setBrush( QColor( QStringLiteral( "mediumaquamarine" ) ) );
 
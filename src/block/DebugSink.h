@@ -30,7 +30,7 @@
 #include "BlockBase.h"
 
 #include "../cgalKernel.h"
-#include "../kinematic/PoseOptions.h"
+#include "../kinematic/Pose.h"
 
 #include "qneblock.h"
 #include "qneport.h"
@@ -78,11 +78,13 @@ class DebugSink : public BlockBase {
       }
     }
 
-    void setPose( const Point_3& position, QQuaternion orientation, PoseOption::Options options ) {
+    void setPose( const Pose& pose ) {
+      const Point_3& position = pose.position();
+
       if( block ) {
-        qDebug() << QDateTime::currentMSecsSinceEpoch() << block->getName() << position.x() << position.y() << position.z() << orientation << options;
+        qDebug() << QDateTime::currentMSecsSinceEpoch() << block->getName() << pose.sequence() << pose.timestamp() << position.x() << position.y() << position.z() << pose.orientation() << pose.options();
       } else {
-        qDebug() << QDateTime::currentMSecsSinceEpoch() << position.x() << position.y() << position.z() << orientation << options;
+        qDebug() << QDateTime::currentMSecsSinceEpoch() << pose.sequence() << pose.timestamp() << position.x() << position.y() << position.z() << pose.orientation() << pose.options();
       }
     }
 
@@ -129,7 +131,7 @@ class DebugSinkFactory : public BlockFactory {
       b->addInputPort( QStringLiteral( "WGS84 Position" ), QLatin1String( SLOT( setWGS84Position( double, double, double ) ) ) );
       b->addInputPort( QStringLiteral( "Position" ), QLatin1String( SLOT( setPosition( QVector3D ) ) ) );
       b->addInputPort( QStringLiteral( "Orientation" ), QLatin1String( SLOT( setOrientation( QQuaternion ) ) ) );
-      b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Point_3&, const QQuaternion, const PoseOption::Options ) ) ) );
+      b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Pose& ) ) ) );
       b->addInputPort( QStringLiteral( "Steering Angle" ), QLatin1String( SLOT( setSteeringAngle( double ) ) ) );
       b->addInputPort( QStringLiteral( "Data" ), QLatin1String( SLOT( setData( const QByteArray& ) ) ) );
 
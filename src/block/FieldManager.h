@@ -45,7 +45,7 @@
 #include "../gui/FieldsOptimitionToolbar.h"
 
 #include "../cgalKernel.h"
-#include "../kinematic/PoseOptions.h"
+#include "../kinematic/Pose.h"
 #include "../kinematic/PathPrimitive.h"
 
 #include "../kinematic/GeographicConvertionWrapper.h"
@@ -69,14 +69,21 @@ class FieldManager : public BlockBase {
     void alphaShape();
 
   public slots:
-    void setPose( const Point_3& position, const QQuaternion orientation, const PoseOption::Options options ) {
+    void setPose( const Pose& pose ) {
+      const Point_3& position = pose.position();
+      const QQuaternion& orientation = pose.orientation();
+      const PoseOption::Options options = pose.options();
+
       if( !options.testFlag( PoseOption::CalculateLocalOffsets ) ) {
         this->position = position;
         this->orientation = orientation;
       }
     }
 
-    void setPoseLeftEdge( const Point_3& position, const QQuaternion, const PoseOption::Options options ) {
+    void setPoseLeftEdge( const Pose& pose ) {
+      const Point_3& position = pose.position();
+      const PoseOption::Options options = pose.options();
+
       if( options.testFlag( PoseOption::CalculateLocalOffsets ) &&
           options.testFlag( PoseOption::CalculateWithoutOrientation ) ) {
         positionLeftEdgeOfImplement = position;
@@ -99,7 +106,10 @@ class FieldManager : public BlockBase {
       }
     }
 
-    void setPoseRightEdge( const Point_3& position, const QQuaternion, const PoseOption::Options options ) {
+    void setPoseRightEdge( const Pose& pose ) {
+      const Point_3& position = pose.position();
+      const PoseOption::Options options = pose.options();
+
       if( options.testFlag( PoseOption::CalculateLocalOffsets ) &&
           options.testFlag( PoseOption::CalculateWithoutOrientation ) ) {
         positionRightEdgeOfImplement = position;
@@ -258,9 +268,9 @@ class FieldManagerFactory : public BlockFactory {
       auto* obj = new FieldManager( mainWindow, rootEntity, tmw );
       auto* b = createBaseBlock( scene, obj, id, true );
 
-      b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Point_3&, const QQuaternion, const PoseOption::Options ) ) ) );
-      b->addInputPort( QStringLiteral( "Pose Left Edge" ), QLatin1String( SLOT( setPoseLeftEdge( const Point_3&, const QQuaternion, const PoseOption::Options ) ) ) );
-      b->addInputPort( QStringLiteral( "Pose Right Edge" ), QLatin1String( SLOT( setPoseRightEdge( const Point_3&, const QQuaternion, const PoseOption::Options ) ) ) );
+      b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Pose& ) ) ) );
+      b->addInputPort( QStringLiteral( "Pose Left Edge" ), QLatin1String( SLOT( setPoseLeftEdge( const Pose& ) ) ) );
+      b->addInputPort( QStringLiteral( "Pose Right Edge" ), QLatin1String( SLOT( setPoseRightEdge( const Pose& ) ) ) );
 
       b->addOutputPort( QStringLiteral( "Field" ), QLatin1String( SIGNAL( fieldChanged( std::shared_ptr<Polygon_with_holes_2> ) ) ) );
 
@@ -20,25 +20,38 @@
 
 #include <QObject>
 #include <QByteArray>
-#include <QTextStream>
+#include <QFile>
+#include <QBasicTimer>
+
+#include <vector>
+#include <algorithm>
+#include <limits>
 
 #include "BlockBase.h"
 
+#include "../helpers/LatencyHistogram.h"
+#include "../helpers/NmeaTokenizer.h"
+#include "../helpers/RawStreamFormat.h"
+#include "../helpers/SimulationClock.h"
+
+// replays a recorded log file
+// the file is memory mapped and split into epochs; every epoch is emitted as one chunk at the time it was
+// originally received. Recordings of "Raw Stream Recorder" are replayed record by record with their timestamps;
+// they are read as they are replayed and seeked with the index at the end of the recording, so they aren't
+// scanned as a whole.
+// For text files, the time of the epochs is taken from the UTC time of the NMEA sentences; if the file
+// has no usable timestamps, every line is an epoch and the lines are emitted with the rate set by "Linerate".
+// "Speed" is a factor to the original timing: 1 is realtime, 0 replays as fast as possible.
+// The timing follows SimulationClock, so in virtual time the replay is as fast as the blocks can process it
 class FileStream : public BlockBase {
     Q_OBJECT
 
   public:
     explicit FileStream()
-      : BlockBase() {
-      fileStream = new QTextStream();
-    }
+      : BlockBase() {}
 
     ~FileStream() override {
-      if( file ) {
-        file->deleteLater();
-      }
-
-      delete fileStream;
+      closeFile();
     }
 
     void emitConfigSignals() override {
@@ -46,66 +59,421 @@ class FileStream : public BlockBase {
 
   signals:
     void dataReceived( const QByteArray& );
+    // seconds since the start of the log
+    void positionChanged( const double );
+    void durationChanged( const double );
 
   public slots:
     void setFilename( const QString& filename ) {
       this->filename = filename;
 
-      if( file ) {
-        fileStream->setDevice( nullptr );
+      closeFile();
+
+      file = new QFile( filename );
+
+      // a file that doesn't exist is created, as the data sent to the block is appended to it
+      if( !file->exists() && file->open( QFile::WriteOnly ) ) {
         file->close();
-        file->deleteLater();
-        file = nullptr;
       }
 
-      file = new QFile( filename );
+      if( !file->open( QFile::ReadOnly ) ) {
+        qWarning() << "FileStream: cannot open" << filename;
+        return;
+      }
+
+      // nothing to replay yet
+      if( file->size() == 0 ) {
+        return;
+      }
+
+      mappedData = reinterpret_cast<const char*>( file->map( 0, file->size() ) );
 
-      if( file->open( QFile::ReadWrite | QFile::Append | QFile::Text ) ) {
-        fileStream->setDevice( file );
-        qDebug() << filename;
-        fileStream->seek( 0 );
-        timer.start( 1000 / linerate, Qt::PreciseTimer, this );
+      if( mappedData == nullptr ) {
+        qWarning() << "FileStream: mapping failed" << filename;
+        return;
+      }
+
+      mappedSize = qint64( file->size() );
+
+      if( RawStream::hasFileMagic( mappedData, mappedSize ) ) {
+        openRecording();
+      } else if( mappedSize > qint64( std::numeric_limits<int>::max() ) ) {
+        // the text logs are split into lines in a QByteArray, which holds at most 2 GiB
+        qWarning() << "FileStream: text logs over 2 GiB can't be replayed, split" << filename;
+        closeFile();
+        return;
       } else {
-        qDebug() << "fail";
+        buildIndex();
+        seekToEpoch( 0 );
       }
+
+      emit durationChanged( double( duration() ) / 1e9 );
+
+      schedule();
     }
 
     void setLinerate( double linerate ) {
       this->linerate = linerate;
 
-      if( qFuzzyIsNull( linerate ) ) {
-        timer.stop();
+      // the timing of the lines depends on the linerate, if the file has no timestamps
+      if( !hasTimestamps && !isRecording && mappedData != nullptr ) {
+        const size_t currentEpoch = nextEpoch;
+        buildIndex();
+        seekToEpoch( qMin( currentEpoch, epochs.size() ) );
+      }
+
+      schedule();
+    }
+
+    void setSpeed( double speed ) {
+      // restart the clock reference at the current position, so the position doesn't jump
+      restartClock( currentTime() );
+      this->speed = qMax( speed, 0. );
+      schedule();
+    }
+
+    void setPaused( double paused ) {
+      if( !qFuzzyIsNull( paused ) ) {
+        if( !this->paused ) {
+          startTime = currentTime();
+          this->paused = true;
+        }
       } else {
-        timer.start( int( 1000 / linerate ), Qt::PreciseTimer, this );
+        if( this->paused ) {
+          this->paused = false;
+          restartClock( startTime );
+        }
       }
+
+      schedule();
+    }
+
+    // position in seconds since the start of the log
+    void seek( double position ) {
+      const qint64 time = qint64( position * 1e9 );
+
+      if( isRecording ) {
+        seekRecording( time );
+      } else {
+        auto it = std::lower_bound( epochs.cbegin(), epochs.cend(), time, []( const Epoch & epoch, qint64 time ) {
+          return epoch.time < time;
+        } );
+
+        seekToEpoch( size_t( std::distance( epochs.cbegin(), it ) ) );
+      }
+
+      schedule();
     }
 
     void sendData( const QByteArray& data ) {
-      *fileStream << data;
+      // the data is appended to the file, but only replayed after reopening it
+      if( writeFile == nullptr ) {
+        writeFile = new QFile( filename );
+
+        if( !writeFile->open( QFile::WriteOnly | QFile::Append ) ) {
+          qDebug() << "FileStream: cannot open for writing" << filename;
+        }
+      }
+
+      if( writeFile->isOpen() ) {
+        writeFile->write( data );
+      }
     }
 
   protected:
     void timerEvent( QTimerEvent* event ) override {
       if( event->timerId() == timer.timerId() ) {
-        if( file && fileStream ) {
-          if( fileStream->atEnd() ) {
-            timer.stop();
-          } else {
-            emit dataReceived( fileStream->readLine().toLatin1() );
+        timer.stop();
+
+        if( qFuzzyIsNull( speed ) ) {
+          // as fast as possible, but return to the event loop now and then
+          for( int i = 0; i < MaxEpochsPerTick && hasNextEpoch(); ++i ) {
+            emitNextEpoch();
+          }
+
+          if( hasNextEpoch() ) {
+            restartClock( timeOfNextEpoch() );
+          }
+        } else {
+          const qint64 time = currentTime();
+
+          while( hasNextEpoch() && timeOfNextEpoch() <= time ) {
+            emitNextEpoch();
           }
         }
+
+        emit positionChanged( double( hasNextEpoch() ? timeOfNextEpoch() : duration() ) / 1e9 );
+
+        schedule();
       }
     }
 
+  private:
+    struct Epoch {
+      // ns since the first epoch
+      qint64 time;
+      // up to the start of the next epoch
+      qint64 offset;
+    };
+
+    static constexpr int MaxEpochsPerTick = 1000;
+    static constexpr qint64 NanosecondsPerDay = qint64( 24 ) * 3600 * 1000000000;
+
+    void closeFile() {
+      timer.stop();
+
+      if( file != nullptr ) {
+        if( mappedData != nullptr ) {
+          file->unmap( reinterpret_cast<uchar*>( const_cast<char*>( mappedData ) ) );
+        }
+
+        file->close();
+        delete file;
+        file = nullptr;
+      }
+
+      if( writeFile != nullptr ) {
+        writeFile->close();
+        delete writeFile;
+        writeFile = nullptr;
+      }
+
+      mappedData = nullptr;
+      mappedSize = 0;
+      epochs.clear();
+      nextEpoch = 0;
+      isRecording = false;
+      hasNextRecord = false;
+    }
+
+    // returns the UTC time of day of a NMEA sentence in ns or -1, if it has none
+    static qint64 timeOfSentence( const NmeaSentence& sentence ) {
+      NmeaField time;
+
+      if( sentence.isType( "GGA" ) || sentence.isType( "RMC" ) || sentence.isType( "GNS" ) ||
+          sentence.isType( "ZDA" ) || sentence.isType( "GST" ) ) {
+        time = sentence.field( 1 );
+      } else if( sentence.isType( "GLL" ) ) {
+        time = sentence.field( 5 );
+      } else {
+        return -1;
+      }
+
+      // the format is like this: HHMMSS.SS
+      double hours = 0;
+      double minutes = 0;
+      double seconds = 0;
+
+      if( time.size() >= 6 &&
+          time.left( 2 ).parseDouble( hours ) &&
+          time.mid( 2 ).left( 2 ).parseDouble( minutes ) &&
+          time.mid( 4 ).parseDouble( seconds ) ) {
+        return qint64( ( hours * 3600 + minutes * 60 + seconds ) * 1e9 );
+      }
+
+      return -1;
+    }
+
+    void buildIndex() {
+      epochs.clear();
+      hasTimestamps = false;
+
+      // the size is checked on opening
+      QByteArray data = QByteArray::fromRawData( mappedData, int( mappedSize ) );
+      NmeaSentence sentence;
+      const char* lineBegin = nullptr;
+      const char* lineEnd = nullptr;
+
+      // first pass: find the lines with a timestamp; an epoch starts at the first line with a new timestamp
+      qint64 firstTime = -1;
+      qint64 lastTime = -1;
+      qint64 dayOffset = 0;
+
+      for( int position = 0, endOfLine = 0;
+           ( endOfLine = NmeaTokenizer::nextLine( data, position, lineBegin, lineEnd ) ) > 0;
+           position = endOfLine ) {
+        if( sentence.parse( lineBegin, lineEnd ) == NmeaSentence::Status::Invalid ) {
+          continue;
+        }
+
+        qint64 time = timeOfSentence( sentence );
+
+        if( time < 0 ) {
+          continue;
+        }
+
+        // rollover at midnight
+        if( lastTime >= 0 && time + dayOffset < lastTime - NanosecondsPerDay / 2 ) {
+          dayOffset += NanosecondsPerDay;
+        }
+
+        time += dayOffset;
+
+        if( firstTime < 0 ) {
+          firstTime = time;
+          // everything before the first timestamp belongs to the first epoch
+          epochs.push_back( Epoch{ 0, 0 } );
+        } else if( time != lastTime ) {
+          // the epochs have to be sorted by time for seeking: a sentence out of order doesn't go back in time
+          epochs.push_back( Epoch{ qMax( time - firstTime, epochs.back().time ), position } );
+        }
+
+        lastTime = time;
+      }
+
+      if( !epochs.empty() ) {
+        hasTimestamps = true;
+        return;
+      }
+
+      // no timestamps: every line is an epoch
+      const qint64 interval = qint64( 1e9 / ( qFuzzyIsNull( linerate ) ? 1. : double( linerate ) ) );
+
+      for( int position = 0, endOfLine = 0;
+           ( endOfLine = NmeaTokenizer::nextLine( data, position, lineBegin, lineEnd ) ) > 0;
+           position = endOfLine ) {
+        epochs.push_back( Epoch{ qint64( epochs.size() ) * interval, position } );
+      }
+
+      if( epochs.empty() ) {
+        epochs.push_back( Epoch{ 0, 0 } );
+      }
+    }
+
+    // the records are read one ahead while replaying; only the end of the recording is looked up on opening
+    void openRecording() {
+      isRecording = true;
+      hasTimestamps = true;
+
+      recording.open( mappedData, mappedSize );
+
+      RawStream::Reader::Record record;
+      firstTimeOfRecording = recording.next( record ) ? record.timestamp : 0;
+      durationOfRecording = qMax( recording.lastTimestamp() - firstTimeOfRecording, qint64( 0 ) );
+
+      seekRecording( 0 );
+    }
+
+    void seekRecording( const qint64 time ) {
+      recording.seek( firstTimeOfRecording + time );
+      timeOfNextRecord = 0;
+      readNextRecord();
+      restartClock( hasNextRecord ? timeOfNextRecord : durationOfRecording );
+    }
+
+    void readNextRecord() {
+      hasNextRecord = recording.next( nextRecord );
+
+      if( hasNextRecord ) {
+        // the steady clock starts anew with every boot; keep appended recordings in order
+        timeOfNextRecord = qMax( nextRecord.timestamp - firstTimeOfRecording, timeOfNextRecord );
+      }
+    }
+
+    bool hasNextEpoch() const {
+      return isRecording ? hasNextRecord : nextEpoch < epochs.size();
+    }
+
+    qint64 timeOfNextEpoch() const {
+      return isRecording ? timeOfNextRecord : epochs[nextEpoch].time;
+    }
+
+    qint64 duration() const {
+      if( isRecording ) {
+        return durationOfRecording;
+      }
+
+      return epochs.empty() ? 0 : epochs.back().time;
+    }
+
+    void emitNextEpoch() {
+      if( isRecording ) {
+        emitData( nextRecord.offset, nextRecord.offset + nextRecord.length );
+        readNextRecord();
+      } else {
+        const size_t index = nextEpoch++;
+        const qint64 begin = epochs[index].offset;
+        const qint64 end = ( index + 1 < epochs.size() ) ? epochs[index + 1].offset : mappedSize;
+        emitData( begin, end );
+      }
+    }
+
+    void emitData( const qint64 begin, const qint64 end ) {
+      if( end > begin ) {
+        // the replayed data counts as received now
+        SampleTimestamp::Scope sampleTimestamp( SampleTimestamp::now() );
+        emit dataReceived( QByteArray( mappedData + begin, int( end - begin ) ) );
+      }
+    }
+
+    void seekToEpoch( const size_t index ) {
+      nextEpoch = index;
+      restartClock( ( nextEpoch < epochs.size() ) ? epochs[nextEpoch].time : 0 );
+    }
+
+    // log time in ns at the current time of SimulationClock
+    qint64 currentTime() const {
+      if( paused || clockStart < 0 ) {
+        return startTime;
+      }
+
+      return startTime + qint64( double( SimulationClock::now() - clockStart ) * speed );
+    }
+
+    void restartClock( const qint64 time ) {
+      startTime = time;
+      clockStart = SimulationClock::now();
+    }
+
+    void schedule() {
+      timer.stop();
+
+      if( paused || !hasNextEpoch() || mappedData == nullptr ) {
+        return;
+      }
+
+      if( !hasTimestamps && qFuzzyIsNull( linerate ) ) {
+        return;
+      }
+
+      int msecsToNextEpoch = 0;
+
+      if( !qFuzzyIsNull( speed ) ) {
+        msecsToNextEpoch = int( qMax( double( timeOfNextEpoch() - currentTime() ) / speed / 1e6, 0. ) );
+      }
+
+      timer.start( msecsToNextEpoch, Qt::PreciseTimer, this );
+    }
+
   public:
     QString filename;
     float linerate = 3;
+    double speed = 1;
+    bool paused = false;
 
   private:
-    QBasicTimer timer;
+    SimulationTimer timer;
+    // time of SimulationClock at startTime; -1: not started
+    qint64 clockStart = -1;
+    qint64 startTime = 0;
 
-    QTextStream* fileStream = nullptr;
     QFile* file = nullptr;
+    QFile* writeFile = nullptr;
+    const char* mappedData = nullptr;
+    qint64 mappedSize = 0;
+
+    std::vector<Epoch> epochs;
+    size_t nextEpoch = 0;
+    bool hasTimestamps = false;
+
+    // recordings of "Raw Stream Recorder" are read with the reader instead of split into epochs
+    bool isRecording = false;
+    RawStream::Reader recording;
+    RawStream::Reader::Record nextRecord;
+    bool hasNextRecord = false;
+    qint64 timeOfNextRecord = 0;
+    qint64 firstTimeOfRecording = 0;
+    qint64 durationOfRecording = 0;
 };
 
 class FileStreamFactory : public BlockFactory {
@@ -129,9 +497,14 @@ class FileStreamFactory : public BlockFactory {
 
       b->addInputPort( QStringLiteral( "File" ), QLatin1String( SLOT( setFilename( const QString& ) ) ) );
       b->addInputPort( QStringLiteral( "Linerate" ), QLatin1String( SLOT( setLinerate( double ) ) ) );
+      b->addInputPort( QStringLiteral( "Speed" ), QLatin1String( SLOT( setSpeed( double ) ) ) );
+      b->addInputPort( QStringLiteral( "Pause" ), QLatin1String( SLOT( setPaused( double ) ) ) );
+      b->addInputPort( QStringLiteral( "Seek" ), QLatin1String( SLOT( seek( double ) ) ) );
       b->addInputPort( QStringLiteral( "Data" ), QLatin1String( SLOT( sendData( const QByteArray& ) ) ) );
 
       b->addOutputPort( QStringLiteral( "Data" ), QLatin1String( SIGNAL( dataReceived( const QByteArray& ) ) ) );
+      b->addOutputPort( QStringLiteral( "Position" ), QLatin1String( SIGNAL( positionChanged( const double ) ) ) );
+      b->addOutputPort( QStringLiteral( "Duration" ), QLatin1String( SIGNAL( durationChanged( const double ) ) ) );
 
       b->setBrush( QColor( QStringLiteral( "gold" ) ) );
 
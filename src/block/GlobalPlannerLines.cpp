@@ -21,39 +21,62 @@
 
 #include <QFileDialog>
 
+#include <algorithm>
+
 #include "../cgal.h"
 #include "../kinematic/CgalWorker.h"
 
-bool GlobalPlannerLines::isLineAlreadyInPlan( const std::shared_ptr<PathPrimitiveLine>& line ) {
-  bool twinFound = false;
+// the parts of the line inside of the field, sorted along the line. The ends of the edges of the boundary and
+// the holes count as on the left or on the right of the line, so a line through a corner is cut once or not at all
+static std::vector<Segment_2> segmentsOfLineInField( const Line_2& line, const Polygon_with_holes_2& field ) {
+  const Point_2 origin = line.point( 0 );
+  const Vector_2 direction = line.to_vector() / std::sqrt( line.to_vector().squared_length() );
+
+  std::vector<double> crossings;
+
+  const auto addCrossings = [&]( const Polygon_2& polygon ) {
+    for( auto edge = polygon.edges_begin(); edge != polygon.edges_end(); ++edge ) {
+      const Vector_2 source = edge->source() - origin;
+      const Vector_2 target = edge->target() - origin;
 
-  for( const auto& step : * ( plan.plan ) ) {
-    if( const auto* pathLine = step->castToLine() ) {
-      if( ( *pathLine ) == ( *line ) ) {
-        twinFound = true;
-        break;
+      // the distances to the left of the line
+      const double sideOfSource = direction.x() * source.y() - direction.y() * source.x();
+      const double sideOfTarget = direction.x() * target.y() - direction.y() * target.x();
+
+      if( ( sideOfSource > 0 ) != ( sideOfTarget > 0 ) ) {
+        const double fraction = sideOfSource / ( sideOfSource - sideOfTarget );
+        crossings.push_back( ( source + ( target - source ) * fraction ) * direction );
       }
     }
+  };
+
+  addCrossings( field.outer_boundary() );
+
+  for( auto hole = field.holes_begin(); hole != field.holes_end(); ++hole ) {
+    addCrossings( *hole );
   }
 
-  return twinFound;
-}
+  // every other crossing enters the field
+  std::sort( crossings.begin(), crossings.end() );
+
+  std::vector<Segment_2> segments;
 
-void GlobalPlannerLines::sortPlan() {
-  sort( plan.plan->begin( ), plan.plan->end( ), [ ]( const auto & lhs, const auto & rhs ) {
-    const auto* lhsLine = lhs->castToLine();
-    const auto* rhsLine = rhs->castToLine();
+  for( size_t i = 0; i + 1 < crossings.size(); i += 2 ) {
+    segments.emplace_back( origin + direction * crossings[i], origin + direction * crossings[i + 1] );
+  }
 
-    return lhsLine->line.has_on_positive_side( rhsLine->line.point( 0 ) );
-  } );
+  return segments;
 }
 
 void GlobalPlannerLines::clearPlan() {
-  plan.plan->clear();
+  // a new plan, as the receivers of the last plan still hold the old one
+  plan = Plan( Plan::Type::OnlyLines );
+  passes.clear();
+  segmentsOfPasses.clear();
 }
 
 void GlobalPlannerLines::showPlan() {
-  if( !plan.plan->empty() ) {
+  if( rootEntity != nullptr && !plan.plan->empty() ) {
     const Point_2 position2D = to2D( position );
 
     constexpr double range = 25;
@@ -61,8 +84,23 @@ void GlobalPlannerLines::showPlan() {
 
     QVector<QVector3D> positions;
 
+    // the passes clipped to the field are shown as they are...
+    if( plan.segmentsInField ) {
+      for( const auto& segmentsOfPass : *plan.segmentsInField ) {
+        for( const auto& segment : segmentsOfPass.second ) {
+          positions << QVector3D( segment.source().x(), segment.source().y(), 0 );
+          positions << QVector3D( segment.target().x(), segment.target().y(), 0 );
+        }
+      }
+
+      m_segmentsMesh->bufferUpdate( positions );
+      m_segmentsEntity->setEnabled( true );
+      return;
+    }
+
+    // ...the others are endless, so show the part around the vehicle
     for( const auto& step : * ( plan.plan ) ) {
-      if( const auto* pathLine = step->castToLine() ) {
+      if( const auto* pathLine = boost::get<PathPrimitiveLine>( &step ) ) {
         const auto& line = pathLine->line;
 
         CGAL::cpp11::result_of<Intersect_2( Segment_2, Line_2 )>::type
@@ -87,24 +125,22 @@ void GlobalPlannerLines::createPlanAB() {
       implementSegment.squared_length() > 1 ) {
     Point_2 position2D = to2D( position );
 
-    if( plan.plan->size() >= std::vector<std::shared_ptr<PathPrimitive>>::size_type( pathsInReserve * 2 + 1 ) ) {
-      if( ( *( plan.plan->cbegin() + ( pathsInReserve - 1 ) ) )->castToLine()->line.has_on_positive_side( position2D ) &&
-          ( *( plan.plan->cend() - pathsInReserve ) )->castToLine()->line.has_on_negative_side( position2D ) ) {
-        return;
-      }
-    }
-
-//    qDebug() << "Long way...";
-
     Segment_2 ab2dSegment = to2D( abSegment );
     Line_2 ab2D = ab2dSegment.supporting_line();
     Point_2 positionProjectedToAbLine = ab2D.projection( position2D );
-    Segment_2 abPerpendicularSegment( position2D, positionProjectedToAbLine );
 
     double angleAbRad = angleOfLineRadians( ab2D );
 
     double implementWidth = std::sqrt( implementSegment.squared_length() );
 
+    // the passes are only valid for the AB line and the width they were made with
+    if( abSegment != abSegmentOfPasses || !qFuzzyCompare( implementWidth, widthOfPasses ) ) {
+      passes.clear();
+      segmentsOfPasses.clear();
+      abSegmentOfPasses = abSegment;
+      widthOfPasses = implementWidth;
+    }
+
     double distanceFromAbLine = std::sqrt( CGAL::squared_distance( position2D, positionProjectedToAbLine ) );
 
     if( ab2D.has_on_positive_side( position2D ) ) {
@@ -113,24 +149,81 @@ void GlobalPlannerLines::createPlanAB() {
 
     int32_t passNumber = std::floor( distanceFromAbLine / implementWidth );
 
-    double moduloDistanceFromAbLine = passNumber * implementWidth;
-
-    for( int offsetCount = -pathsToGenerate ; offsetCount <= pathsToGenerate ; ++offsetCount ) {
-      double offsetDistance = moduloDistanceFromAbLine + offsetCount * implementWidth;
+    // enough passes in reserve on both sides -> nothing to do
+    if( !passes.empty() &&
+        passNumber >= firstPass + pathsInReserve &&
+        passNumber <= firstPass + int32_t( passes.size() ) - 1 - pathsInReserve ) {
+      return;
+    }
 
-      auto offsetVector = polarOffset( M_PI + angleAbRad, offsetDistance );
+    // the line of the pass, clipped to the field once here
+    const auto lineOfPass = [&]( const int32_t pass ) {
+      auto offsetVector = polarOffset( M_PI + angleAbRad, pass * implementWidth );
 
-      auto newLine = std::make_shared<PathPrimitiveLine>(
-                       Line_2( ab2dSegment.source() - offsetVector, ab2dSegment.target() - offsetVector ),
-                       implementWidth, true, passNumber + offsetCount );
+      PathPrimitiveLine line( Line_2( ab2dSegment.source() - offsetVector, ab2dSegment.target() - offsetVector ),
+                              implementWidth, true, pass );
 
-      if( !isLineAlreadyInPlan( newLine ) ) {
-        plan.plan->push_back( newLine );
+      if( currentField ) {
+        segmentsOfPasses[pass] = segmentsOfLineInField( line.line, *currentField );
       }
+
+      return line;
+    };
+
+    const int32_t firstWanted = passNumber - pathsToGenerate;
+    const int32_t lastWanted = passNumber + pathsToGenerate;
+    bool changed = false;
+
+    // no overlap with the passes in the store: start anew
+    if( passes.empty() ||
+        firstWanted > firstPass + int32_t( passes.size() ) - 1 ||
+        lastWanted < firstPass ) {
+      changed = !passes.empty();
+      passes.clear();
+      segmentsOfPasses.clear();
+      firstPass = firstWanted;
+    }
+
+    // remove the passes that left the window...
+    while( !passes.empty() && firstPass < firstWanted ) {
+      segmentsOfPasses.erase( firstPass );
+      passes.pop_front();
+      ++firstPass;
+      changed = true;
+    }
+
+    while( !passes.empty() && firstPass + int32_t( passes.size() ) - 1 > lastWanted ) {
+      segmentsOfPasses.erase( firstPass + int32_t( passes.size() ) - 1 );
+      passes.pop_back();
+      changed = true;
+    }
+
+    // ...and add the ones that entered it
+    while( firstPass > firstWanted ) {
+      --firstPass;
+      passes.push_front( lineOfPass( firstPass ) );
+      changed = true;
     }
 
-    sortPlan();
-    emit planChanged( plan );
+    while( firstPass + int32_t( passes.size() ) - 1 < lastWanted ) {
+      passes.push_back( lineOfPass( firstPass + int32_t( passes.size() ) ) );
+      changed = true;
+    }
+
+    if( changed ) {
+      // the plan is sorted from right to left relative to A->B, so the highest pass comes first;
+      // a new plan, as the receivers of the last plan still hold the old one
+      plan = Plan( Plan::Type::OnlyLines, std::vector<PathPrimitive>( passes.crbegin(), passes.crend() ) );
+
+      // the lines are parallel, so the receivers can find the nearest one without searching
+      plan.setParallelLines( passes.back().line, polarOffset( M_PI + angleAbRad, implementWidth ) );
+
+      if( currentField ) {
+        plan.segmentsInField = std::make_shared<const std::map<int32_t, std::vector<Segment_2>>>( segmentsOfPasses );
+      }
+
+      emit planChanged( plan );
+    }
   }
 }
 
@@ -169,9 +262,9 @@ void GlobalPlannerLines::snapPlanAB() {
 
 GlobalPlannerLines::GlobalPlannerLines( QWidget* mainWindow, Qt3DCore::QEntity* rootEntity, GeographicConvertionWrapper* tmw )
   : BlockBase(),
-    mainWindow( mainWindow ), tmw( tmw ) {
+    mainWindow( mainWindow ), rootEntity( rootEntity ), tmw( tmw ) {
   // a point marker -> orange
-  {
+  if( rootEntity != nullptr ) {
     aPointEntity = new Qt3DCore::QEntity( rootEntity );
 
     aPointMesh = new Qt3DExtras::QSphereMesh( aPointEntity );
@@ -205,7 +298,7 @@ GlobalPlannerLines::GlobalPlannerLines( QWidget* mainWindow, Qt3DCore::QEntity*
   }
 
   // b point marker -> purple
-  {
+  if( rootEntity != nullptr ) {
     bPointEntity = new Qt3DCore::QEntity( rootEntity );
     bPointMesh = new Qt3DExtras::QSphereMesh( bPointEntity );
     bPointMesh->setRadius( .2f );
@@ -238,7 +331,7 @@ GlobalPlannerLines::GlobalPlannerLines( QWidget* mainWindow, Qt3DCore::QEntity*
   }
 
   // test for recording
-  {
+  if( rootEntity != nullptr ) {
     m_baseEntity = new Qt3DCore::QEntity( rootEntity );
     m_baseTransform = new Qt3DCore::QTransform( m_baseEntity );
     m_baseEntity->addComponent( m_baseTransform );
@@ -45,7 +45,7 @@
 #include "../gui/FieldsOptimitionToolbar.h"
 
 #include "../cgalKernel.h"
-#include "../kinematic/PoseOptions.h"
+#include "../kinematic/Pose.h"
 #include "../kinematic/PathPrimitive.h"
 #include "../kinematic/Plan.h"
 
@@ -53,6 +53,8 @@
 
 #include <QVector>
 #include <QSharedPointer>
+#include <deque>
+#include <map>
 #include <utility>
 
 class CgalThread;
@@ -62,25 +64,35 @@ class GlobalPlannerLines : public BlockBase {
     Q_OBJECT
 
   public:
+    // without a root entity, the plan is made but not shown
     explicit GlobalPlannerLines( QWidget* mainWindow, Qt3DCore::QEntity* rootEntity, GeographicConvertionWrapper* tmw );
 
     ~GlobalPlannerLines() {}
 
   public slots:
-    void setPose( const Point_3& position, const QQuaternion orientation, const PoseOption::Options options ) {
+    void setPose( const Pose& pose ) {
+      const Point_3& position = pose.position();
+      const QQuaternion& orientation = pose.orientation();
+      const PoseOption::Options options = pose.options();
+
       if( !options.testFlag( PoseOption::CalculateLocalOffsets ) ) {
         this->position = position;
         this->orientation = orientation;
 
-        aPointTransform->setRotation( orientation );
-        bPointTransform->setRotation( orientation );
+        if( rootEntity != nullptr ) {
+          aPointTransform->setRotation( orientation );
+          bPointTransform->setRotation( orientation );
+        }
 
         createPlanAB();
         showPlan();
       }
     }
 
-    void setPoseLeftEdge( const Point_3& position, const QQuaternion, const PoseOption::Options options ) {
+    void setPoseLeftEdge( const Pose& pose ) {
+      const Point_3& position = pose.position();
+      const PoseOption::Options options = pose.options();
+
       if( options.testFlag( PoseOption::CalculateLocalOffsets ) &&
           options.testFlag( PoseOption::CalculateWithoutOrientation ) ) {
         positionLeftEdgeOfImplement = position;
@@ -94,7 +106,10 @@ class GlobalPlannerLines : public BlockBase {
       }
     }
 
-    void setPoseRightEdge( const Point_3& position, const QQuaternion, const PoseOption::Options options ) {
+    void setPoseRightEdge( const Pose& pose ) {
+      const Point_3& position = pose.position();
+      const PoseOption::Options options = pose.options();
+
       if( options.testFlag( PoseOption::CalculateLocalOffsets ) &&
           options.testFlag( PoseOption::CalculateWithoutOrientation ) ) {
         positionRightEdgeOfImplement = position;
@@ -110,13 +125,19 @@ class GlobalPlannerLines : public BlockBase {
 
     void setField( std::shared_ptr<Polygon_with_holes_2> field ) {
       currentField = field;
+
+      // the passes are clipped to the field when they are made
+      clearPlan();
+      createPlanAB();
     }
 
     void a_clicked() {
-      aPointTransform->setTranslation( convertPoint3ToQVector3D( position ) );
+      if( rootEntity != nullptr ) {
+        aPointTransform->setTranslation( convertPoint3ToQVector3D( position ) );
 
-      aPointEntity->setEnabled( true );
-      bPointEntity->setEnabled( false );
+        aPointEntity->setEnabled( true );
+        bPointEntity->setEnabled( false );
+      }
 
       aPoint = position;
 
@@ -125,8 +146,11 @@ class GlobalPlannerLines : public BlockBase {
 
     void b_clicked() {
       qDebug() << "b_clicked()";
-      bPointTransform->setTranslation( convertPoint3ToQVector3D( position ) );
-      bPointEntity->setEnabled( true );
+
+      if( rootEntity != nullptr ) {
+        bPointTransform->setTranslation( convertPoint3ToQVector3D( position ) );
+        bPointEntity->setEnabled( true );
+      }
 
       bPoint = position;
 
@@ -190,10 +214,8 @@ class GlobalPlannerLines : public BlockBase {
 //    void requestNewRunNumber();
 
   private:
-    bool isLineAlreadyInPlan( const std::shared_ptr<PathPrimitiveLine>& line );
     void createPlanAB();
     void snapPlanAB();
-    void sortPlan();
     void showPlan();
     void clearPlan();
 
@@ -221,6 +243,19 @@ class GlobalPlannerLines : public BlockBase {
 
     Plan plan = Plan( Plan::Type::OnlyLines );
 
+  private:
+    // the lines of the plan by pass number: passes[i] is the pass firstPass + i, without gaps.
+    // Only the passes entering or leaving the window around the current pass are added or removed; the lines are
+    // valid for the AB line and the implement width they were created with
+    std::deque<PathPrimitiveLine> passes;
+    int32_t firstPass = 0;
+
+    // the parts of the passes in the store inside of the field, by pass number; empty without a field
+    std::map<int32_t, std::vector<Segment_2>> segmentsOfPasses;
+
+    Segment_3 abSegmentOfPasses = Segment_3( Point_3( 0, 0, 0 ), Point_3( 0, 0, 0 ) );
+    double widthOfPasses = 0;
+
   private:
     QWidget* mainWindow = nullptr;
     Qt3DCore::QEntity* rootEntity = nullptr;
@@ -289,9 +324,9 @@ class GlobalPlannerFactory : public BlockFactory {
       auto* obj = new GlobalPlannerLines( mainWindow, rootEntity, tmw );
       auto* b = createBaseBlock( scene, obj, id, true );
 
-      b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Point_3&, const QQuaternion, const PoseOption::Options ) ) ) );
-      b->addInputPort( QStringLiteral( "Pose Left Edge" ), QLatin1String( SLOT( setPoseLeftEdge( const Point_3&, const QQuaternion, const PoseOption::Options ) ) ) );
-      b->addInputPort( QStringLiteral( "Pose Right Edge" ), QLatin1String( SLOT( setPoseRightEdge( const Point_3&, const QQuaternion, const PoseOption::Options ) ) ) );
+      b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Pose& ) ) ) );
+      b->addInputPort( QStringLiteral( "Pose Left Edge" ), QLatin1String( SLOT( setPoseLeftEdge( const Pose& ) ) ) );
+      b->addInputPort( QStringLiteral( "Pose Right Edge" ), QLatin1String( SLOT( setPoseRightEdge( const Pose& ) ) ) );
 
       b->addInputPort( QStringLiteral( "Field" ), QLatin1String( SLOT( setField( std::shared_ptr<Polygon_with_holes_2> ) ) ) );
 
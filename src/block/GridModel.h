@@ -41,7 +41,7 @@
 #include "BlockBase.h"
 
 #include "../cgalKernel.h"
-#include "../kinematic/PoseOptions.h"
+#include "../kinematic/Pose.h"
 
 #include "../3d/BufferMesh.h"
 
@@ -104,7 +104,9 @@ class GridModel : public BlockBase {
     }
 
   public slots:
-    void setPose( const Point_3& position, QQuaternion, PoseOption::Options ) {
+    void setPose( const Pose& pose ) {
+      const Point_3& position = pose.position();
+
       m_distanceMeasurementTransform->setTranslation( convertPoint3ToQVector3D( position ) );
 
       QVector3D positionModulo( float( std::floor( ( position.x() ) / xStepMax ) * xStepMax ),
@@ -284,7 +286,7 @@ class GridModelFactory : public BlockFactory {
       auto* obj = new GridModel( rootEntity, m_cameraEntity );
       auto* b = createBaseBlock( scene, obj, id, true );
 
-      b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Point_3&, const QQuaternion, const PoseOption::Options ) ) ) );
+      b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Pose& ) ) ) );
 
       return b;
     }
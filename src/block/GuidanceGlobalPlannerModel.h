@@ -45,7 +45,7 @@
 #include "qneport.h"
 
 #include "../cgalKernel.h"
-#include "../kinematic/PoseOptions.h"
+#include "../kinematic/Pose.h"
 #include "../kinematic/PathPrimitive.h"
 #include "../kinematic/Plan.h"
 
@@ -182,7 +182,11 @@ class GlobalPlannerModel : public BlockBase {
       recalculateMeshes();
     }
 
-    void setPose( const Point_3& position, const QQuaternion orientation, const PoseOption::Options options ) {
+    void setPose( const Pose& pose ) {
+      const Point_3& position = pose.position();
+      const QQuaternion& orientation = pose.orientation();
+      const PoseOption::Options options = pose.options();
+
       if( !options.testFlag( PoseOption::CalculateLocalOffsets ) ) {
         this->position = position;
         this->orientation = orientation;
@@ -337,7 +341,7 @@ class GlobalPlannerModelFactory : public BlockFactory {
       auto* obj = new GlobalPlannerModel( rootEntity );
       auto* b = createBaseBlock( scene, obj, id, true );
 
-      b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Point_3&, const QQuaternion, const PoseOption::Options ) ) ) );
+      b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Pose& ) ) ) );
       b->addInputPort( QStringLiteral( "Plan" ), QLatin1String( SLOT( setPlan( const Plan& ) ) ) );
 
       return b;
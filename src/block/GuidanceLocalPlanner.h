@@ -29,9 +29,10 @@
 #include "qneport.h"
 
 #include "../cgalKernel.h"
-#include "../kinematic/PoseOptions.h"
+#include "../kinematic/Pose.h"
 #include "../kinematic/PathPrimitive.h"
 #include "../kinematic/Plan.h"
+#include "../kinematic/SegmentIndex.h"
 
 #include <QVector>
 #include <QSharedPointer>
@@ -43,8 +44,16 @@ class LocalPlanner : public BlockBase {
     explicit LocalPlanner()
       : BlockBase() {}
 
+    bool canMoveToControlThread() const override {
+      return true;
+    }
+
   public slots:
-    void setPose( const Point_3& position, QQuaternion orientation, PoseOption::Options options ) {
+    void setPose( const Pose& pose ) {
+      const Point_3& position = pose.position();
+      const QQuaternion& orientation = pose.orientation();
+      const PoseOption::Options options = pose.options();
+
       if( !options.testFlag( PoseOption::CalculateLocalOffsets ) ) {
         this->position = position;
         this->orientation = orientation;
@@ -56,45 +65,76 @@ class LocalPlanner : public BlockBase {
           // local planner for lines: find the nearest line and put it into the local plan
           if( globalPlan.type == Plan::Type::OnlyLines ) {
             double distanceSquared = qInf();
-            typeof( globalPlan.plan->front() ) nearestLine;
-
-            for( const auto& pathPrimitive : *globalPlan.plan ) {
-              auto line = pathPrimitive->castToLine();
-              double currentDistanceSquared = CGAL::squared_distance( line->line, position2D );
-
-              if( currentDistanceSquared < distanceSquared ) {
-                nearestLine = pathPrimitive;
-                distanceSquared = currentDistanceSquared;
-              } else {
-                // the plan is ordered, so we can take the fast way out...
-                break;
+            const PathPrimitiveLine* nearestLine = nullptr;
+
+            const int indexOfNearestLine = globalPlan.indexOfNearestParallelLine( position2D );
+
+            if( indexOfNearestLine >= 0 ) {
+              // parallel lines: the nearest one follows from the distance to the first one
+              nearestLine = boost::get<PathPrimitiveLine>( &globalPlan.plan->at( size_t( indexOfNearestLine ) ) );
+            } else {
+              for( const auto& pathPrimitive : *globalPlan.plan ) {
+                const auto* line = boost::get<PathPrimitiveLine>( &pathPrimitive );
+                double currentDistanceSquared = CGAL::squared_distance( line->line, position2D );
+
+                if( currentDistanceSquared < distanceSquared ) {
+                  nearestLine = line;
+                  distanceSquared = currentDistanceSquared;
+                } else {
+                  // the plan is ordered, so we can take the fast way out...
+                  break;
+                }
               }
             }
 
-            plan.type = Plan::Type::OnlyLines;
-            plan.plan->clear();
-            auto line = nearestLine->castToLine();
-
-            if( line->anyDirection ) {
-              double angleNearestLine = angleOfLineDegrees( line->line );
+            PathPrimitiveLine line = *nearestLine;
 
-              if( std::abs( orientation.toEulerAngles().z() - angleNearestLine ) > 95 ) {
-                nearestLine = std::make_shared<PathPrimitiveLine>(
-                                      line->line.opposite(),
-                                      line->implementWidth, line->anyDirection, line->passNumber );
+            if( line.anyDirection ) {
+              double angleNearestLine = angleOfLineDegrees( line.line );
 
+              if( std::abs( pose.yaw() - angleNearestLine ) > 95 ) {
+                line.reverse();
               }
             }
 
-            plan.plan->push_back( nearestLine );
+            // a new plan, as the receivers of the last plan still hold the old one
+            plan = Plan( Plan::Type::OnlyLines, std::vector<PathPrimitive>( 1, line ) );
+            plan.segmentsInField = globalPlan.segmentsInField;
             emit planChanged( plan );
           }
+
+          // local planner for segments: find the nearest segment with the index and put it into the local plan
+          if( globalPlan.type == Plan::Type::OnlySegments ) {
+            const int indexOfNearestSegment = segmentIndex.nearestSegment( position2D );
+
+            if( indexOfNearestSegment >= 0 ) {
+              PathPrimitiveSegment segment = *boost::get<PathPrimitiveSegment>( &globalPlan.plan->at( size_t( indexOfNearestSegment ) ) );
+
+              if( segment.anyDirection ) {
+                double angleNearestSegment = angleOfLineDegrees( segment.segment.supporting_line() );
+
+                if( std::abs( pose.yaw() - angleNearestSegment ) > 95 ) {
+                  segment.reverse();
+                }
+              }
+
+              plan = Plan( Plan::Type::OnlySegments, std::vector<PathPrimitive>( 1, segment ) );
+              emit planChanged( plan );
+            }
+          }
         }
       }
     }
 
     void setPlan( const Plan& plan ) {
       this->globalPlan = plan;
+
+      if( plan.type == Plan::Type::OnlySegments ) {
+        segmentIndex.build( plan );
+      } else {
+        segmentIndex.clear();
+      }
+
 //      emit planChanged( plan );
     }
 
@@ -109,6 +149,7 @@ class LocalPlanner : public BlockBase {
   private:
     Plan globalPlan;
     Plan plan;
+    SegmentIndex segmentIndex;
 };
 
 class LocalPlannerFactory : public BlockFactory {
@@ -130,7 +171,7 @@ class LocalPlannerFactory : public BlockFactory {
       auto* obj = new LocalPlanner();
       auto* b = createBaseBlock( scene, obj, id );
 
-      b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Point_3&, const QQuaternion, const PoseOption::Options ) ) ) );
+      b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Pose& ) ) ) );
       b->addInputPort( QStringLiteral( "Plan" ), QLatin1String( SLOT( setPlan( const Plan& ) ) ) );
       b->addOutputPort( QStringLiteral( "Plan" ), QLatin1String( SIGNAL( planChanged( const Plan& ) ) ) );
 
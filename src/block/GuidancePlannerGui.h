@@ -31,7 +31,7 @@
 #include "qneport.h"
 
 #include "../cgalKernel.h"
-#include "../kinematic/PoseOptions.h"
+#include "../kinematic/Pose.h"
 
 class PlannerGui : public BlockBase {
     Q_OBJECT
@@ -42,7 +42,11 @@ class PlannerGui : public BlockBase {
         rootEntity( rootEntity ) {}
 
   public slots:
-    void setPose( const Point_3& position, QQuaternion orientation, PoseOption::Options options ) {
+    void setPose( const Pose& pose ) {
+      const Point_3& position = pose.position();
+      const QQuaternion& orientation = pose.orientation();
+      const PoseOption::Options options = pose.options();
+
       if( !options.testFlag( PoseOption::CalculateLocalOffsets ) ) {
         this->position = position;
         this->orientation = orientation;
@@ -85,7 +89,7 @@ class PlannerGuiFactory : public BlockFactory {
       auto* obj = new PlannerGui( rootEntity );
       auto* b = createBaseBlock( scene, obj, id, true );
 
-      b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Point_3&, const QQuaternion, const PoseOption::Options ) ) ) );
+      b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Pose& ) ) ) );
       b->addOutputPort( QStringLiteral( "A clicked" ), QLatin1String( SIGNAL( a_clicked() ) ) );
       b->addOutputPort( QStringLiteral( "B clicked" ), QLatin1String( SIGNAL( b_clicked() ) ) );
       b->addOutputPort( QStringLiteral( "Snap clicked" ), QLatin1String( SIGNAL( snap_clicked() ) ) );
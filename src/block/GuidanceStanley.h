@@ -29,9 +29,11 @@
 #include "qneport.h"
 
 #include "../cgalKernel.h"
-#include "../kinematic/PoseOptions.h"
+#include "../kinematic/Pose.h"
 #include "../kinematic/PathPrimitive.h"
 
+#include "../helpers/LatencyHistogram.h"
+
 #include <QVector>
 #include <QSharedPointer>
 
@@ -45,6 +47,10 @@ class StanleyGuidance : public BlockBase {
     explicit StanleyGuidance()
       : BlockBase() {}
 
+    bool canMoveToControlThread() const override {
+      return true;
+    }
+
   public slots:
     void setSteeringAngle( double steeringAngle ) {
       steeringAngle2Ago = steeringAngle1Ago;
@@ -52,11 +58,10 @@ class StanleyGuidance : public BlockBase {
       this->steeringAngle = double( steeringAngle );
     }
 
-    void setPose( const Point_3& position, QQuaternion orientation, PoseOption::Options options ) {
-      if( !options.testFlag( PoseOption::CalculateLocalOffsets ) ) {
-        this->position = position;
-        this->orientation1Ago = this->orientation;
-        this->orientation = orientation;
+    void setPose( const Pose& pose ) {
+      if( !pose.options().testFlag( PoseOption::CalculateLocalOffsets ) ) {
+        this->pose1Ago = this->pose;
+        this->pose = pose;
       }
     }
 
@@ -66,10 +71,10 @@ class StanleyGuidance : public BlockBase {
 
     void setXte( double distance ) {
       if( !qIsInf( distance ) ) {
-        double stanleyYawCompensation = /*normalizeAngle*/( ( headingOfPathRadians ) - ( qDegreesToRadians( double( orientation.toEulerAngles().z() ) ) ) );
+        double stanleyYawCompensation = /*normalizeAngle*/( ( headingOfPathRadians ) - ( qDegreesToRadians( double( pose.yaw() ) ) ) );
         double stanleyXteCompensation = atan( ( stanleyGainK * double( -distance ) ) / ( double( velocity ) + stanleyGainKSoft ) );
         double stanleyYawDampening = /*normalizeAngle*/( stanleyGainDampeningYaw *
-            ( qDegreesToRadians( normalizeAngleDegrees( double( this->orientation1Ago.toEulerAngles().z() ) ) - normalizeAngleDegrees( double( this->orientation.toEulerAngles().z() ) ) ) -
+            ( qDegreesToRadians( normalizeAngleDegrees( double( this->pose1Ago.yaw() ) ) - normalizeAngleDegrees( double( this->pose.yaw() ) ) ) -
               ( yawTrajectory1Ago - headingOfPathRadians ) ) );
         double stanleySteeringDampening = /*normalizeAngle*/( stanleyGainDampeningSteering * qDegreesToRadians( steeringAngle1Ago - steeringAngle ) );
         double steerAngleRequested = qRadiansToDegrees( normalizeAngleRadians( stanleyYawCompensation + stanleyXteCompensation + stanleyYawDampening + stanleySteeringDampening ) );
@@ -82,8 +87,10 @@ class StanleyGuidance : public BlockBase {
           steerAngleRequested = -maxSteeringAngle;
         }
 
-//        qDebug() << fixed << forcesign << qSetRealNumberPrecision( 4 ) << stanleyYawCompensation << stanleyXteCompensation << stanleyYawDampening << stanleySteeringDampening << steerAngleRequested << normalizeAngleRadians( headingOfPathRadians ) << normalizeAngleRadians( qDegreesToRadians( orientation.toEulerAngles().z() ) );
+//        qDebug() << fixed << forcesign << qSetRealNumberPrecision( 4 ) << stanleyYawCompensation << stanleyXteCompensation << stanleyYawDampening << stanleySteeringDampening << steerAngleRequested << normalizeAngleRadians( headingOfPathRadians ) << normalizeAngleRadians( qDegreesToRadians( pose.yaw() ) );
 
+        // the age of data at the outputs is measured from the reception of the fix of the pose
+        SampleTimestamp::Scope sampleTimestamp( pose.timestamp() );
         emit steerAngleChanged( float( steerAngleRequested ) );
         yawTrajectory1Ago = headingOfPathRadians;
       }
@@ -120,9 +127,8 @@ class StanleyGuidance : public BlockBase {
   private:
 
   public:
-    Point_3 position = Point_3( 0, 0, 0 );
-    QQuaternion orientation = QQuaternion();
-    QQuaternion orientation1Ago = QQuaternion();
+    Pose pose;
+    Pose pose1Ago;
     double velocity = 0;
     double headingOfPathRadians = 0;
     double distance = 0;
@@ -159,7 +165,7 @@ class StanleyGuidanceFactory : public BlockFactory {
       auto* obj = new StanleyGuidance();
       auto* b = createBaseBlock( scene, obj, id );
 
-      b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Point_3&, const QQuaternion, const PoseOption::Options ) ) ) );
+      b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Pose& ) ) ) );
       b->addInputPort( QStringLiteral( "Steering Angle" ), QLatin1String( SLOT( setSteeringAngle( double ) ) ) );
       b->addInputPort( QStringLiteral( "Velocity" ), QLatin1String( SLOT( setVelocity( double ) ) ) );
       b->addInputPort( QStringLiteral( "XTE" ), QLatin1String( SLOT( setXte( double ) ) ) );
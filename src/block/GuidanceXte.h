@@ -29,9 +29,12 @@
 #include "qneport.h"
 
 #include "../cgalKernel.h"
-#include "../kinematic/PoseOptions.h"
+#include "../kinematic/Pose.h"
 #include "../kinematic/PathPrimitive.h"
 #include "../kinematic/Plan.h"
+#include "../kinematic/SegmentIndex.h"
+
+#include "../helpers/LatencyHistogram.h"
 
 #include <QVector>
 #include <QSharedPointer>
@@ -47,9 +50,19 @@ class XteGuidance : public BlockBase {
     explicit XteGuidance()
       : BlockBase() {}
 
+    bool canMoveToControlThread() const override {
+      return true;
+    }
+
   public slots:
-    void setPose( const Point_3& position, const QQuaternion, const PoseOption::Options options ) {
+    void setPose( const Pose& pose ) {
+      const Point_3& position = pose.position();
+      const PoseOption::Options options = pose.options();
+
       if( !options.testFlag( PoseOption::CalculateLocalOffsets ) ) {
+        // the age of data at the outputs is measured from the reception of the fix of the pose
+        SampleTimestamp::Scope sampleTimestamp( pose.timestamp() );
+
         const Point_2 position2D = to2D( position );
 
         if( !plan.plan->empty() ) {
@@ -59,17 +72,24 @@ class XteGuidance : public BlockBase {
             double distanceSquared = qInf();
             const PathPrimitiveLine* nearestLine = nullptr;
 
-
-            for( const auto& pathPrimitive : *plan.plan ) {
-              auto line = pathPrimitive->castToLine();
-              double currentDistanceSquared = CGAL::squared_distance( line->line, position2D );
-
-              if( currentDistanceSquared < distanceSquared ) {
-                nearestLine = line;
-                distanceSquared = currentDistanceSquared;
-              } else {
-                // the plan is ordered, so we can take the fast way out...
-                break;
+            const int indexOfNearestLine = plan.indexOfNearestParallelLine( position2D );
+
+            if( indexOfNearestLine >= 0 ) {
+              // parallel lines: the nearest one follows from the distance to the first one
+              nearestLine = boost::get<PathPrimitiveLine>( &plan.plan->at( size_t( indexOfNearestLine ) ) );
+              distanceSquared = CGAL::squared_distance( nearestLine->line, position2D );
+            } else {
+              for( const auto& pathPrimitive : *plan.plan ) {
+                const auto* line = boost::get<PathPrimitiveLine>( &pathPrimitive );
+                double currentDistanceSquared = CGAL::squared_distance( line->line, position2D );
+
+                if( currentDistanceSquared < distanceSquared ) {
+                  nearestLine = line;
+                  distanceSquared = currentDistanceSquared;
+                } else {
+                  // the plan is ordered, so we can take the fast way out...
+                  break;
+                }
               }
             }
 
@@ -82,30 +102,62 @@ class XteGuidance : public BlockBase {
             emit headingOfPathChanged( angleOfLineDegrees( nearestLine->line ) );
             emit xteChanged( offsetDistance );
             emit passNumberChanged( nearestLine->passNumber );
+            emit distanceToEndOfPassChanged( plan.distanceToEndOfPass( nearestLine->passNumber, position2D, nearestLine->line.to_vector() ) );
             return;
           }
+
+          // curved AB lines and contours: find the nearest segment with the index
+          if( plan.type == Plan::Type::OnlySegments ) {
+            const int indexOfNearestSegment = segmentIndex.nearestSegment( position2D );
+
+            if( indexOfNearestSegment >= 0 ) {
+              const auto* nearestSegment = boost::get<PathPrimitiveSegment>( &plan.plan->at( size_t( indexOfNearestSegment ) ) );
+              const Line_2 lineOfSegment = nearestSegment->segment.supporting_line();
+
+              double offsetDistance = std::sqrt( CGAL::squared_distance( nearestSegment->segment, position2D ) );
+
+              if( lineOfSegment.has_on_negative_side( position2D ) ) {
+                offsetDistance = -offsetDistance;
+              }
+
+              emit headingOfPathChanged( angleOfLineDegrees( lineOfSegment ) );
+              emit xteChanged( offsetDistance );
+              emit passNumberChanged( nearestSegment->passNumber );
+              emit distanceToEndOfPassChanged( plan.distanceToEndOfPass( nearestSegment->passNumber, position2D, nearestSegment->segment.to_vector() ) );
+              return;
+            }
+          }
         }
 
         emit headingOfPathChanged( qInf() );
         emit xteChanged( qInf() );
         emit passNumberChanged( qInf() );
+        emit distanceToEndOfPassChanged( qInf() );
       }
     }
 
     void setPlan( const Plan& plan ) {
       this->plan = plan;
+
+      if( plan.type == Plan::Type::OnlySegments ) {
+        segmentIndex.build( plan );
+      } else {
+        segmentIndex.clear();
+      }
     }
 
     void emitConfigSignals() override {
       emit xteChanged( qInf() );
       emit headingOfPathChanged( qInf() );
       emit passNumberChanged( qInf() );
+      emit distanceToEndOfPassChanged( qInf() );
     }
 
   signals:
     void xteChanged( double );
     void headingOfPathChanged( double );
     void passNumberChanged( double );
+    void distanceToEndOfPassChanged( double );
 
   private:
     double normalizeAngleRadians( double angle ) {
@@ -139,6 +191,7 @@ class XteGuidance : public BlockBase {
 
   private:
     Plan plan;
+    SegmentIndex segmentIndex;
 };
 
 class XteGuidanceFactory : public BlockFactory {
@@ -160,12 +213,13 @@ class XteGuidanceFactory : public BlockFactory {
       auto* obj = new XteGuidance();
       auto* b = createBaseBlock( scene, obj, id );
 
-      b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Point_3&, const QQuaternion, const PoseOption::Options ) ) ) );
+      b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Pose& ) ) ) );
       b->addInputPort( QStringLiteral( "Plan" ), QLatin1String( SLOT( setPlan( const Plan& ) ) ) );
 
       b->addOutputPort( QStringLiteral( "XTE" ), QLatin1String( SIGNAL( xteChanged( double ) ) ) );
       b->addOutputPort( QStringLiteral( "Heading of Path" ), QLatin1String( SIGNAL( headingOfPathChanged( double ) ) ) );
       b->addOutputPort( QStringLiteral( "Pass #" ), QLatin1String( SIGNAL( passNumberChanged( double ) ) ) );
+      b->addOutputPort( QStringLiteral( "Distance to End of Pass" ), QLatin1String( SIGNAL( distanceToEndOfPassChanged( double ) ) ) );
 
       return b;
     }
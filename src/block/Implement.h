@@ -34,7 +34,7 @@
 
 #include "ImplementSection.h"
 
-#include "../kinematic/PoseOptions.h"
+#include "../kinematic/Pose.h"
 
 #include "../gui/MyMainWindow.h"
 
@@ -71,12 +71,10 @@ class Implement : public BlockBase {
 
       emit leftEdgeChanged( QVector3D( 0, float( -width / 2 ), 0 ) );
       emit rightEdgeChanged( QVector3D( 0, float( width / 2 ), 0 ) );
-      auto dummyPoint = Point_3( 0, 0, 0 );
-      auto dummyQuaternion = QQuaternion();
       auto dummyFlags = PoseOption::CalculateLocalOffsets |
                         PoseOption::CalculateWithoutOrientation |
                         PoseOption::CalculateFromPivotPoint;
-      emit triggerLocalPose( dummyPoint, dummyQuaternion, dummyFlags );
+      emit triggerLocalPose( Pose( Point_3( 0, 0, 0 ), QQuaternion(), dummyFlags, Pose::now(), 0 ) );
       emit implementChanged( this );
     }
 
@@ -126,7 +124,7 @@ class Implement : public BlockBase {
     }
 
   signals:
-    void triggerLocalPose( const Point_3&, const QQuaternion, const PoseOption::Options );
+    void triggerLocalPose( const Pose& );
     void leftEdgeChanged( QVector3D );
     void rightEdgeChanged( QVector3D );
     void implementChanged( const QPointer<Implement> );
@@ -188,7 +186,7 @@ class ImplementFactory : public BlockFactory {
         mainWindow->addDockWidget( object->dock, KDDockWidgets::Location_OnBottom, firstDock );
       }
 
-      b->addOutputPort( QStringLiteral( "Trigger Calculation of Local Pose" ), QLatin1String( SIGNAL( triggerLocalPose( const Point_3&, const QQuaternion, const PoseOption::Options ) ) ) );
+      b->addOutputPort( QStringLiteral( "Trigger Calculation of Local Pose" ), QLatin1String( SIGNAL( triggerLocalPose( const Pose& ) ) ) );
       b->addOutputPort( QStringLiteral( "Implement Data" ), QLatin1String( SIGNAL( implementChanged( const QPointer<Implement> ) ) ) );
       b->addOutputPort( QStringLiteral( "Section Control Data" ), QLatin1String( SIGNAL( sectionsChanged() ) ) );
       b->addOutputPort( QStringLiteral( "Position Left Edge" ), QLatin1String( SIGNAL( leftEdgeChanged( QVector3D ) ) ) );
@@ -0,0 +1,149 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <QObject>
+#include <QDockWidget>
+#include <QSizePolicy>
+#include <QMenu>
+
+#include "../gui/MyMainWindow.h"
+#include "../gui/ThreeValuesDock.h"
+
+#include "BlockBase.h"
+#include "ValueDockBlockBase.h"
+
+class LatencyDockBlock : public ValueDockBlockBase {
+    Q_OBJECT
+
+  public:
+    explicit LatencyDockBlock( const QString& uniqueName,
+                               MyMainWindow* mainWindow )
+      : ValueDockBlockBase( uniqueName ) {
+      widget = new ThreeValuesDock( mainWindow );
+
+      widget->setDescriptions( QStringLiteral( "p50" ), QStringLiteral( "p99" ), QStringLiteral( "Max" ) );
+    }
+
+    ~LatencyDockBlock() {
+      widget->deleteLater();
+    }
+
+    virtual const QFont& getFont() override {
+      return widget->fontOfLabel();
+    }
+    virtual int getPrecision() override {
+      return widget->precision;
+    }
+    virtual int getFieldWidth() override {
+      return widget->fieldWidth;
+    }
+    virtual double getScale() override {
+      return widget->scale;
+    }
+    virtual bool captionEnabled() override {
+      return widget->captionEnabled();
+    }
+
+    virtual void setFont( const QFont& font ) override {
+      widget->setFontOfLabel( font );
+    }
+    virtual void setPrecision( int precision ) override {
+      widget->precision = precision;
+    }
+    virtual void setFieldWidth( int fieldWidth ) override {
+      widget->fieldWidth = fieldWidth;
+    }
+    virtual void setScale( double scale ) override {
+      widget->scale = scale;
+    }
+    virtual void setCaptionEnabled( bool enabled ) override {
+      widget->setCaptionEnabled( enabled );
+    }
+
+  public slots:
+    void setName( const QString& name ) override {
+      dock->setTitle( name );
+      dock->toggleAction()->setText( QStringLiteral( "Latency: " ) + name );
+      widget->setName( name );
+    }
+
+    // in ms; connect it to "Age of Data" of an output block
+    void setAgeOfData( const double p50, const double p99, const double max ) {
+      widget->setValues( p50, p99, max );
+    }
+
+  public:
+    ThreeValuesDock* widget = nullptr;
+};
+
+class LatencyDockBlockFactory : public BlockFactory {
+    Q_OBJECT
+
+  public:
+    LatencyDockBlockFactory( MyMainWindow* mainWindow,
+                             KDDockWidgets::Location location,
+                             QMenu* menu )
+      : BlockFactory(),
+        mainWindow( mainWindow ),
+        location( location ),
+        menu( menu ) {}
+
+    QString getNameOfFactory() override {
+      return QStringLiteral( "LatencyDockBlock" );
+    }
+
+    virtual void addToCombobox( QComboBox* combobox ) override {
+      combobox->addItem( getNameOfFactory(), QVariant::fromValue( this ) );
+    }
+
+    virtual QNEBlock* createBlock( QGraphicsScene* scene, int id ) override {
+      if( id != 0 && !isIdUnique( scene, id ) ) {
+        id = QNEBlock::getNextUserId();
+      }
+
+      auto* object = new LatencyDockBlock( getNameOfFactory() + QString::number( id ),
+          mainWindow );
+      auto* b = createBaseBlock( scene, object, id );
+
+      object->dock->setTitle( getNameOfFactory() );
+      object->dock->setWidget( object->widget );
+
+      menu->addAction( object->dock->toggleAction() );
+
+      if( ValueDockBlockBase::firstThreeValuesDock == nullptr ) {
+        mainWindow->addDockWidget( object->dock, location );
+        ValueDockBlockBase::firstThreeValuesDock = object->dock;
+      } else {
+        mainWindow->addDockWidget( object->dock, KDDockWidgets::Location_OnBottom, ValueDockBlockBase::firstThreeValuesDock );
+      }
+
+      b->addInputPort( QStringLiteral( "Age of Data" ), QLatin1String( SLOT( setAgeOfData( const double, const double, const double ) ) ) );
+
+      b->setBrush( QColor( QStringLiteral( "lightsalmon" ) ) );
+
+      return b;
+    }
+
+  private:
+    MyMainWindow* mainWindow = nullptr;
+    KDDockWidgets::Location location;
+    QMenu* menu = nullptr;
+};
+
@@ -0,0 +1,162 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <QObject>
+#include <QByteArray>
+
+#include "BlockBase.h"
+
+#include "../helpers/NmeaTokenizer.h"
+
+// common base of the NMEA parsers: buffers the incoming data, splits it into sentences and
+// hands every complete sentence to parseSentence() of the derived class
+class NmeaParserBase : public BlockBase {
+    Q_OBJECT
+
+  public:
+    enum class DropPolicy : int {
+      // drop the oldest bytes and resync on the next start of a sentence
+      DropOldest = 0,
+      // throw away the whole buffer
+      DropAll = 1
+    };
+
+  public:
+    explicit NmeaParserBase()
+      : BlockBase() {}
+
+    virtual ~NmeaParserBase() {}
+
+    bool canMoveToControlThread() const override {
+      return true;
+    }
+
+  signals:
+    // number of complete sentences parsed in one call of setData()
+    void sentencesPerCallChanged( const double );
+    // incomplete data, still waiting for the end of the line
+    void bufferedBytesChanged( const double );
+    // sum of all dropped bytes since the start
+    void droppedBytesChanged( const double );
+    // sum of all sentences with an incorrect checksum since the start
+    void checksumErrorsChanged( const double );
+
+  public slots:
+    void setData( const QByteArray& data ) {
+      dataToParse.append( data );
+      parseData();
+    }
+
+    void setMaxBufferSize( const double maxBufferSize ) {
+      this->maxBufferSize = qMax( int( maxBufferSize ), int( MinBufferSize ) );
+    }
+
+    void setDropPolicy( const double dropPolicy ) {
+      this->dropPolicy = qFuzzyIsNull( dropPolicy ) ? DropPolicy::DropOldest : DropPolicy::DropAll;
+    }
+
+  public:
+    // parses all complete sentences in the buffer
+    void parseData() {
+      const char* lineBegin = nullptr;
+      const char* lineEnd = nullptr;
+      int positionInBuffer = 0;
+      int numSentences = 0;
+      const double checksumErrorsBefore = checksumErrors;
+
+      // nextLine() returns the position after the line, if a complete line could be found; the newline has to be there
+      for( int endOfLine = NmeaTokenizer::nextLine( dataToParse, positionInBuffer, lineBegin, lineEnd );
+           endOfLine > 0;
+           endOfLine = NmeaTokenizer::nextLine( dataToParse, positionInBuffer, lineBegin, lineEnd ) ) {
+        switch( sentence.parse( lineBegin, lineEnd ) ) {
+          case NmeaSentence::Status::Valid:
+            parseSentence( sentence );
+            break;
+
+          // only counted, as a noisy link would flood the log
+          case NmeaSentence::Status::ChecksumIncorrect:
+            ++checksumErrors;
+            break;
+
+          default:
+            break;
+        }
+
+        positionInBuffer = endOfLine;
+        ++numSentences;
+      }
+
+      // remove all the parsed lines at once from the buffer
+      if( positionInBuffer > 0 ) {
+        dataToParse.remove( 0, positionInBuffer );
+      }
+
+      // what is left is an incomplete line; if it gets too big, there is something wrong with the
+      // stream (or it isn't NMEA at all), so enforce the limit
+      if( dataToParse.size() > maxBufferSize ) {
+        int bytesToDrop = dataToParse.size();
+
+        if( dropPolicy == DropPolicy::DropOldest ) {
+          bytesToDrop -= maxBufferSize;
+
+          // resync on the next start of a sentence, so no half sentence is left in the buffer
+          int indexOfStart = dataToParse.indexOf( '$', bytesToDrop );
+
+          bytesToDrop = ( indexOfStart < 0 ) ? dataToParse.size() : indexOfStart;
+        }
+
+        dataToParse.remove( 0, bytesToDrop );
+        droppedBytes += double( bytesToDrop );
+        emit droppedBytesChanged( droppedBytes );
+      }
+
+      if( checksumErrors != checksumErrorsBefore ) {
+        emit checksumErrorsChanged( checksumErrors );
+      }
+
+      if( numSentences != lastSentencesPerCall ) {
+        lastSentencesPerCall = numSentences;
+        emit sentencesPerCallChanged( numSentences );
+      }
+
+      if( dataToParse.size() != lastBufferedBytes ) {
+        lastBufferedBytes = dataToParse.size();
+        emit bufferedBytesChanged( lastBufferedBytes );
+      }
+    }
+
+  protected:
+    virtual void parseSentence( const NmeaSentence& sentence ) = 0;
+
+  public:
+    static constexpr int MinBufferSize = 128;
+
+    int maxBufferSize = 16384;
+    DropPolicy dropPolicy = DropPolicy::DropOldest;
+
+  private:
+    QByteArray dataToParse;
+    NmeaSentence sentence;
+
+    double droppedBytes = 0;
+    double checksumErrors = 0;
+    int lastSentencesPerCall = 0;
+    int lastBufferedBytes = 0;
+};
@@ -20,14 +20,14 @@
 
 #include <QObject>
 
-#include "BlockBase.h"
+#include "NmeaParserBase.h"
 
-class NmeaParserGGA : public BlockBase {
+class NmeaParserGGA : public NmeaParserBase {
     Q_OBJECT
 
   public:
     explicit NmeaParserGGA()
-      : BlockBase() {
+      : NmeaParserBase() {
     }
 
   signals:
@@ -37,146 +37,53 @@ class NmeaParserGGA : public BlockBase {
     void numSatelitesChanged( const double );
     void ageOfDifferentialDataChanged( const double );
 
-  public slots:
-    void setData( const QByteArray& data ) {
-      dataToParse.append( data );
-      parseData();
-    }
-
-  public:
-    void parseData() {
-      // relies heavy on the implementations of QTextStream, QByteArray and QString
-      // read the docs about them!
-
-      // create a qtextstream out of dataToParse. dataToParse is not altered by it!
-      QTextStream textstream( dataToParse, QIODevice::ReadOnly );
-
-      QString currentLine;
-      bool hasChecksum = false;
-      quint8 checksumFromNmeaSentence = 0;
-
-      // returns true if a line could be read; the newline has to be there or it returns false
-      // currentLine has no trailing end-of-line characters
-      if( textstream.readLineInto( &currentLine ) ) {
-
-        // calculate the checksum
-        quint8 checksum = 0;
-
-        // i=1; skip the first character for checksum generation
-        for( int i = 1; i < currentLine.size(); ++i ) {
-          char c = currentLine.at( i ).toLatin1();
-
-          // checksum handling
-          if( c == '*' ) {
-            // only read out an existing checksum
-            if( ( i + 3 ) <= currentLine.size() ) {
-              // read the next two chars from the string and convert from hex to quint8
-              QString checksumOfCurrentLine;
-              checksumOfCurrentLine.append( currentLine.at( i + 1 ) );
-              checksumOfCurrentLine.append( currentLine.at( i + 2 ) );
-              checksumFromNmeaSentence = quint8( checksumOfCurrentLine.toUInt( nullptr, 16 ) );
-
-              hasChecksum = true;
-            }
-
-            // remove all chars behind the * from the string; works with an empty checksum too
-            currentLine.remove( i, currentLine.count() - i );
-
-            break;
-          } else {
-            // the checksum is a simple XOR of all chars in the sentence, but without the $ and the checksum itself
-            checksum ^= c;
-          }
-        }
-
-        QStringList nmeaFields = currentLine.split( ',' );
-
-        // cut off the first three characters: these are '$' and the talker id
-        nmeaFields.first().remove( 0, 3 );
-
-        // check the checksum
-        if( hasChecksum ) {
-          if( checksum == checksumFromNmeaSentence ) {
-//            qDebug() << "Checksum correct.";
-          } else {
-            qDebug() << "Checksum incorrect!";
-          }
-
-          // as most users will have either a M8T or F9P, the interface documentation of ublox
-          // is used for the format of the NMEA sentences
-          // https://www.u-blox.com/de/product/zed-f9p-module -> interface manual
-
-          // GGA and GNS are exactly the same, but GNS displays more than 12 satelites (max 99)
-          if( nmeaFields.front() == QStringLiteral( "GGA" ) || nmeaFields.front() == QStringLiteral( "GNS" ) ) {
-            if( nmeaFields.count() >= 14 ) {
-              qDebug() << nmeaFields;
-
-              QStringList::const_iterator nmeaFileIterator = nmeaFields.cbegin();
-              // skip first field
-              ++nmeaFileIterator;
-
-              // skip UTC time
-              ++nmeaFileIterator;
+  protected:
+    void parseSentence( const NmeaSentence& sentence ) override {
+      // as most users will have either a M8T or F9P, the interface documentation of ublox
+      // is used for the format of the NMEA sentences
+      // https://www.u-blox.com/de/product/zed-f9p-module -> interface manual
 
-              // the format is like this: DDMM.MMMMM
-              double latitude = nmeaFileIterator->leftRef( 2 ).toDouble();
-              latitude += nmeaFileIterator->midRef( 2, 2 ).toDouble() / 60;
-              latitude += nmeaFileIterator->midRef( 4 ).toDouble() / 60;
-              ++nmeaFileIterator;
+      // GGA and GNS are exactly the same, but GNS displays more than 12 satelites (max 99)
+      if( ( sentence.isType( "GGA" ) || sentence.isType( "GNS" ) ) && sentence.count() >= 14 ) {
+        // field 1 is the UTC time
 
-              if( ( *nmeaFileIterator ) == 'S' ) {
-                latitude = -latitude;
-              }
+        // the format is like this: DDMM.MMMMM
+        double latitude = 0;
 
-              ++nmeaFileIterator;
-
-              // the format is like this: DDDMM.MMMMM
-              double longitude = nmeaFileIterator->leftRef( 3 ).toDouble();
-              longitude += nmeaFileIterator->midRef( 3, 2 ).toDouble() / 60;
-              longitude += nmeaFileIterator->midRef( 5 ).toDouble() / 60;
-              ++nmeaFileIterator;
-
-              if( ( *nmeaFileIterator ) == 'W' ) {
-                longitude = -longitude;
-              }
-
-              ++nmeaFileIterator;
-
-              emit fixQualityChanged( nmeaFileIterator->toFloat() );
-              ++nmeaFileIterator;
+        if( !sentence.field( 2 ).toDegrees( 2, latitude ) ) {
+          return;
+        }
 
-              emit numSatelitesChanged( nmeaFileIterator->toFloat() );
-              ++nmeaFileIterator;
+        if( sentence.field( 3 ) == 'S' ) {
+          latitude = -latitude;
+        }
 
-              emit hdopChanged( nmeaFileIterator->toFloat() );
-              ++nmeaFileIterator;
+        // the format is like this: DDDMM.MMMMM
+        double longitude = 0;
 
-              double height = nmeaFileIterator->toDouble();
-              ++nmeaFileIterator;
+        if( !sentence.field( 4 ).toDegrees( 3, longitude ) ) {
+          return;
+        }
 
-              // skip unit of height
-              ++nmeaFileIterator;
+        if( sentence.field( 5 ) == 'W' ) {
+          longitude = -longitude;
+        }
 
-              // skip geoid seperation
-              ++nmeaFileIterator;
+        emit fixQualityChanged( sentence.field( 6 ).toDouble() );
+        emit numSatelitesChanged( sentence.field( 7 ).toDouble() );
+        emit hdopChanged( sentence.field( 8 ).toDouble() );
 
-              // skip unit of geoid seperation
-              ++nmeaFileIterator;
+        double height = sentence.field( 9 ).toDouble();
 
-              emit ageOfDifferentialDataChanged( nmeaFileIterator->toFloat() );
+        // field 10: unit of height
+        // field 11: geoid seperation
+        // field 12: unit of geoid seperation
 
-              emit globalPositionChanged( latitude, longitude, height );
-            }
-          }
-        }
+        emit ageOfDifferentialDataChanged( sentence.field( 13 ).toDouble() );
 
-        // remove the line from the buffer
-        dataToParse.remove( 0, int( textstream.pos() ) );
+        emit globalPositionChanged( latitude, longitude, height );
       }
     }
-
-  private:
-    QByteArray dataToParse;
 };
 
 class NmeaParserGGAFactory : public BlockFactory {
@@ -199,6 +106,8 @@ class NmeaParserGGAFactory : public BlockFactory {
       auto* b = createBaseBlock( scene, obj, id );
 
       b->addInputPort( QStringLiteral( "Data" ), QLatin1String( SLOT( setData( const QByteArray& ) ) ) );
+      b->addInputPort( QStringLiteral( "Max Buffer Size" ), QLatin1String( SLOT( setMaxBufferSize( const double ) ) ) );
+      b->addInputPort( QStringLiteral( "Drop Policy" ), QLatin1String( SLOT( setDropPolicy( const double ) ) ) );
 
       b->addOutputPort( QStringLiteral( "WGS84 Position" ), QLatin1String( SIGNAL( globalPositionChanged( const double, const double, const double ) ) ) );
       b->addOutputPort( QStringLiteral( "TOW" ), QLatin1String( SIGNAL( towChanched( const double ) ) ) );
@@ -207,6 +116,11 @@ class NmeaParserGGAFactory : public BlockFactory {
       b->addOutputPort( QStringLiteral( "Num Satelites" ), QLatin1String( SIGNAL( numSatelitesChanged( const double ) ) ) );
       b->addOutputPort( QStringLiteral( "Age of Differential Data" ), QLatin1String( SIGNAL( ageOfDifferentialDataChanged( const double ) ) ) );
 
+      b->addOutputPort( QStringLiteral( "Sentences per Call" ), QLatin1String( SIGNAL( sentencesPerCallChanged( const double ) ) ) );
+      b->addOutputPort( QStringLiteral( "Buffered Bytes" ), QLatin1String( SIGNAL( bufferedBytesChanged( const double ) ) ) );
+      b->addOutputPort( QStringLiteral( "Dropped Bytes" ), QLatin1String( SIGNAL( droppedBytesChanged( const double ) ) ) );
+      b->addOutputPort( QStringLiteral( "Checksum Errors" ), QLatin1String( SIGNAL( checksumErrorsChanged( const double ) ) ) );
+
       b->setBrush( QColor( QStringLiteral( "mediumaquamarine" ) ) );
 
       return b;
@@ -20,149 +20,60 @@
 
 #include <QObject>
 
-#include "BlockBase.h"
+#include "NmeaParserBase.h"
 
-class NmeaParserRMC : public BlockBase {
+class NmeaParserRMC : public NmeaParserBase {
     Q_OBJECT
 
   public:
     explicit NmeaParserRMC()
-      : BlockBase() {
+      : NmeaParserBase() {
     }
 
   signals:
     void globalPositionChanged( const double, const double, const double );
     void velocityChanged( const double );
 
-  public slots:
-    void setData( const QByteArray& data ) {
-      dataToParse.append( data );
-      parseData();
-    }
-
-  public:
-    void parseData() {
-      // relies heavy on the implementations of QTextStream, QByteArray and QString
-      // read the docs about them!
-
-      // create a qtextstream out of dataToParse. dataToParse is not altered by it!
-      QTextStream textstream( dataToParse, QIODevice::ReadOnly );
-
-      QString currentLine;
-      bool hasChecksum = false;
-      quint8 checksumFromNmeaSentence = 0;
-
-      // returns true if a line could be read; the newline has to be there or it returns false
-      // currentLine has no trailing end-of-line characters
-      if( textstream.readLineInto( &currentLine ) ) {
-
-        // calculate the checksum
-        quint8 checksum = 0;
-
-        // i=1; skip the first character for checksum generation
-        for( int i = 1; i < currentLine.size(); ++i ) {
-          char c = currentLine.at( i ).toLatin1();
-
-          // checksum handling
-          if( c == '*' ) {
-            // only read out an existing checksum
-            if( ( i + 3 ) <= currentLine.size() ) {
-              // read the next two chars from the string and convert from hex to quint8
-              QString checksumOfCurrentLine;
-              checksumOfCurrentLine.append( currentLine.at( i + 1 ) );
-              checksumOfCurrentLine.append( currentLine.at( i + 2 ) );
-              checksumFromNmeaSentence = quint8( checksumOfCurrentLine.toUInt( nullptr, 16 ) );
-
-              hasChecksum = true;
-            }
-
-            // remove all chars behind the * from the string; works with an empty checksum too
-            currentLine.remove( i, currentLine.count() - i );
-
-            break;
-          } else {
-            // the checksum is a simple XOR of all chars in the sentence, but without the $ and the checksum itself
-            checksum ^= c;
-          }
-        }
-
-        QStringList nmeaFields = currentLine.split( ',' );
-
-        // cut off the first three characters: these are '$' and the talker id
-        nmeaFields.first().remove( 0, 3 );
-
-        // check the checksum
-        if( hasChecksum ) {
-          if( checksum == checksumFromNmeaSentence ) {
-//            qDebug() << "Checksum correct.";
-          } else {
-            qDebug() << "Checksum incorrect!";
-          }
-
-          // as most users will have either a M8T or F9P, the interface documentation of ublox
-          // is used for the format of the NMEA sentences
-          // https://www.u-blox.com/de/product/zed-f9p-module -> interface manual
-          if( nmeaFields.front() == QStringLiteral( "RMC" ) ) {
-
-            if( nmeaFields.count() >= 12 ) {
-              qDebug() << nmeaFields;
-
-              QStringList::const_iterator nmeaFileIterator = nmeaFields.cbegin();
-              // skip first field
-              ++nmeaFileIterator;
-
-              // skip UTC time
-              ++nmeaFileIterator;
-
-              // skip status
-              ++nmeaFileIterator;
+  protected:
+    void parseSentence( const NmeaSentence& sentence ) override {
+      // as most users will have either a M8T or F9P, the interface documentation of ublox
+      // is used for the format of the NMEA sentences
+      // https://www.u-blox.com/de/product/zed-f9p-module -> interface manual
+      if( sentence.isType( "RMC" ) && sentence.count() >= 12 ) {
+        // field 1: UTC time
+        // field 2: status
 
-              // the format is like this: DDMM.MMMMM
-              double latitude = nmeaFileIterator->leftRef( 2 ).toDouble();
-              latitude += nmeaFileIterator->midRef( 2, 2 ).toDouble() / 60;
-              latitude += nmeaFileIterator->midRef( 4 ).toDouble() / 60;
-              ++nmeaFileIterator;
+        // the format is like this: DDMM.MMMMM
+        double latitude = 0;
 
-              if( ( *nmeaFileIterator ) == 'S' ) {
-                latitude = -latitude;
-              }
-
-              ++nmeaFileIterator;
-
-              // the format is like this: DDDMM.MMMMM
-              double longitude = nmeaFileIterator->leftRef( 3 ).toDouble();
-              longitude += nmeaFileIterator->midRef( 3, 2 ).toDouble() / 60;
-              longitude += nmeaFileIterator->midRef( 5 ).toDouble() / 60;
-              ++nmeaFileIterator;
+        if( !sentence.field( 3 ).toDegrees( 2, latitude ) ) {
+          return;
+        }
 
-              if( ( *nmeaFileIterator ) == 'W' ) {
-                longitude = -longitude;
-              }
+        if( sentence.field( 4 ) == 'S' ) {
+          latitude = -latitude;
+        }
 
-              ++nmeaFileIterator;
+        // the format is like this: DDDMM.MMMMM
+        double longitude = 0;
 
-              // speed in kn: 1kn = 463m/900s
-              double velocity = nmeaFileIterator->leftRef( 2 ).toDouble();
-              velocity += nmeaFileIterator->midRef( 2 ).toDouble() / 10;
-              velocity *= 463;
-              velocity /= 900;
+        if( !sentence.field( 5 ).toDegrees( 3, longitude ) ) {
+          return;
+        }
 
-              emit velocityChanged( float( velocity ) );
-              emit globalPositionChanged( latitude, longitude, 0 );
-            }
-          }
+        if( sentence.field( 6 ) == 'W' ) {
+          longitude = -longitude;
         }
 
-        // remove the line from the buffer
-        dataToParse.remove( 0, int( textstream.pos() ) );
+        // speed in kn: 1kn = 463m/900s
+        double velocity = sentence.field( 7 ).toDouble();
+        velocity *= 463;
+        velocity /= 900;
+
+        emit velocityChanged( float( velocity ) );
+        emit globalPositionChanged( latitude, longitude, 0 );
       }
     }
-
-  public:
-
-
-  private:
-    QByteArray dataToParse;
 };
 
 class NmeaParserRMCFactory : public BlockFactory {
@@ -185,9 +96,17 @@ class NmeaParserRMCFactory : public BlockFactory {
       auto* b = createBaseBlock( scene, obj, id );
 
       b->addInputPort( QStringLiteral( "Data" ), QLatin1String( SLOT( setData( const QByteArray& ) ) ) );
+      b->addInputPort( QStringLiteral( "Max Buffer Size" ), QLatin1String( SLOT( setMaxBufferSize( const double ) ) ) );
+      b->addInputPort( QStringLiteral( "Drop Policy" ), QLatin1String( SLOT( setDropPolicy( const double ) ) ) );
+
       b->addOutputPort( QStringLiteral( "WGS84 Position" ), QLatin1String( SIGNAL( globalPositionChanged( const double, const double, const double ) ) ) );
       b->addOutputPort( QStringLiteral( "Velocity" ), QLatin1String( SIGNAL( velocityChanged( const double ) ) ) );
 
+      b->addOutputPort( QStringLiteral( "Sentences per Call" ), QLatin1String( SIGNAL( sentencesPerCallChanged( const double ) ) ) );
+      b->addOutputPort( QStringLiteral( "Buffered Bytes" ), QLatin1String( SIGNAL( bufferedBytesChanged( const double ) ) ) );
+      b->addOutputPort( QStringLiteral( "Dropped Bytes" ), QLatin1String( SIGNAL( droppedBytesChanged( const double ) ) ) );
+      b->addOutputPort( QStringLiteral( "Checksum Errors" ), QLatin1String( SIGNAL( checksumErrorsChanged( const double ) ) ) );
+
       b->setBrush( QColor( QStringLiteral( "mediumaquamarine" ) ) );
 
       return b;
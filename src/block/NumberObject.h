@@ -35,6 +35,10 @@ class NumberObject : public BlockBase {
       emit numberChanged( number );
     }
 
+    QVariant constantValue() const override {
+      return QVariant( double( number ) );
+    }
+
     void toJSON( QJsonObject& json ) override {
       QJsonObject valuesObject;
       valuesObject[QStringLiteral( "Number" )] = double( number );
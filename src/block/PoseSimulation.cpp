@@ -29,8 +29,11 @@
 
 void PoseSimulation::timerEvent( QTimerEvent* event ) {
   if( event->timerId() == m_timer.timerId() ) {
-    constexpr double msPerS = 1000;
-    double elapsedTime = double ( m_time.restart() ) / msPerS;
+    constexpr double nsPerS = 1e9;
+    const qint64 now = SimulationClock::now();
+    double elapsedTime = double( now - m_lastStep ) / nsPerS;
+    periodJitter->recordDuration( qAbs( now - m_lastStep - qint64( m_interval ) * 1000000 ) );
+    m_lastStep = now;
     QQuaternion lastOrientation = m_orientation;
 
     float steerAngle = 0;
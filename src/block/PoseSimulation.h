@@ -35,6 +35,9 @@
 
 #include "../kinematic/GeographicConvertionWrapper.h"
 
+#include "../helpers/SimulationClock.h"
+#include "../helpers/LatencyHistogram.h"
+
 using namespace std;
 using namespace GeographicLib;
 
@@ -45,9 +48,20 @@ class PoseSimulation : public BlockBase {
     explicit PoseSimulation( GeographicConvertionWrapper* geographicConvertionWrapper )
       : BlockBase(),
         geographicConvertionWrapper( geographicConvertionWrapper ) {
+      periodJitter = new LatencyStatistics( this );
+      connect( periodJitter, &LatencyStatistics::latencyChanged, this, &PoseSimulation::periodJitterChanged );
+      connect( periodJitter, &LatencyStatistics::p50Changed, this, &PoseSimulation::periodJitterP50Changed );
+      connect( periodJitter, &LatencyStatistics::p99Changed, this, &PoseSimulation::periodJitterP99Changed );
+      connect( periodJitter, &LatencyStatistics::maxChanged, this, &PoseSimulation::periodJitterMaxChanged );
+
       setSimulation( false );
     }
 
+    // the simulation is the clock of the control loop: on the control thread, a busy GUI doesn't delay its steps
+    bool canMoveToControlThread() const override {
+      return true;
+    }
+
   public slots:
     void setInterval( int interval ) {
       m_interval = interval;
@@ -66,7 +80,7 @@ class PoseSimulation : public BlockBase {
 
       if( enabled ) {
         m_timer.start( m_interval, Qt::PreciseTimer, this );
-        m_time.start();
+        m_lastStep = SimulationClock::now();
       } else {
         m_timer.stop();
       }
@@ -121,6 +135,12 @@ class PoseSimulation : public BlockBase {
     void orientationChanged( QQuaternion );
     void velocityChanged( double );
 
+    // deviation of the time between two steps from the interval in ms, emitted once a second
+    void periodJitterChanged( const double, const double, const double );
+    void periodJitterP50Changed( const double );
+    void periodJitterP99Changed( const double );
+    void periodJitterMaxChanged( const double );
+
   public:
     virtual void emitConfigSignals() override {
       emit steerAngleChanged( m_steerAngle );
@@ -135,9 +155,10 @@ class PoseSimulation : public BlockBase {
     bool m_autosteerEnabled = false;
     int m_interval = 50;
 
-    QBasicTimer m_timer;
-    int m_timerId;
-    QElapsedTimer m_time;
+    SimulationTimer m_timer;
+    // time of the last step; SimulationClock, ns
+    qint64 m_lastStep = 0;
+    LatencyStatistics* periodJitter = nullptr;
 
     float m_steerAngle = 0;
     float m_steerAngleFromAutosteer = 0;
@@ -180,6 +201,10 @@ class PoseSimulationFactory : public BlockFactory {
       b->addOutputPort( QStringLiteral( "Orientation" ), QLatin1String( SIGNAL( orientationChanged( QQuaternion ) ) ) );
       b->addOutputPort( QStringLiteral( "Steering Angle" ), QLatin1String( SIGNAL( steeringAngleChanged( double ) ) ) );
       b->addOutputPort( QStringLiteral( "Velocity" ), QLatin1String( SIGNAL( velocityChanged( double ) ) ) );
+      b->addOutputPort( QStringLiteral( "Period Jitter" ), QLatin1String( SIGNAL( periodJitterChanged( const double, const double, const double ) ) ) );
+      b->addOutputPort( QStringLiteral( "Period Jitter p50" ), QLatin1String( SIGNAL( periodJitterP50Changed( const double ) ) ) );
+      b->addOutputPort( QStringLiteral( "Period Jitter p99" ), QLatin1String( SIGNAL( periodJitterP99Changed( const double ) ) ) );
+      b->addOutputPort( QStringLiteral( "Period Jitter Max" ), QLatin1String( SIGNAL( periodJitterMaxChanged( const double ) ) ) );
 
       b->addInputPort( QStringLiteral( "Autosteer Enabled" ), QLatin1String( SLOT( autosteerEnabled( bool ) ) ) );
       b->addInputPort( QStringLiteral( "Autosteer Steering Angle" ), QLatin1String( SLOT( setSteerAngleFromAutosteer( double ) ) ) );
@@ -29,7 +29,9 @@
 #include "qneport.h"
 
 #include "../cgalKernel.h"
-#include "../kinematic/PoseOptions.h"
+#include "../kinematic/Pose.h"
+
+#include "../helpers/LatencyHistogram.h"
 
 class PoseSynchroniser : public BlockBase {
     Q_OBJECT
@@ -43,7 +45,12 @@ class PoseSynchroniser : public BlockBase {
       this->position = position;
       QElapsedTimer timer;
       timer.start();
-      emit poseChanged( this->position, orientation, PoseOption::NoOptions );
+      // the pose is stamped with the time the data of the fix was received, the sequence number counts the fixes
+      const qint64 timestamp = SampleTimestamp::current();
+      Pose pose( this->position, orientation, PoseOption::NoOptions, timestamp != 0 ? timestamp : Pose::now(), ++sequence );
+
+      SampleTimestamp::Scope sampleTimestamp( pose.timestamp() );
+      emit poseChanged( pose );
 //      qDebug() << "Cycle Time PoseSynchroniser:  " << timer.nsecsElapsed() << "ns";
     }
 
@@ -52,16 +59,21 @@ class PoseSynchroniser : public BlockBase {
     }
 
   signals:
-    void poseChanged( const Point_3&, const QQuaternion, const PoseOption::Options );
+    void poseChanged( const Pose& );
 
   public:
+    bool canMoveToControlThread() const override {
+      return true;
+    }
+
     virtual void emitConfigSignals() override {
-      emit poseChanged( position, orientation, PoseOption::NoOptions );
+      emit poseChanged( Pose( position, orientation, PoseOption::NoOptions, Pose::now(), sequence ) );
     }
 
   public:
     Point_3 position = Point_3( 0, 0, 0 );
     QQuaternion orientation = QQuaternion();
+    quint64 sequence = 0;
 };
 
 class PoseSynchroniserFactory : public BlockFactory {
@@ -86,7 +98,7 @@ class PoseSynchroniserFactory : public BlockFactory {
       b->addInputPort( QStringLiteral( "Position" ), QLatin1String( SLOT( setPosition( const Point_3& ) ) ) );
       b->addInputPort( QStringLiteral( "Orientation" ), QLatin1String( SLOT( setOrientation( const QQuaternion ) ) ) );
 
-      b->addOutputPort( QStringLiteral( "Pose" ), QLatin1String( SIGNAL( poseChanged( const Point_3&, const QQuaternion, const PoseOption::Options ) ) ) );
+      b->addOutputPort( QStringLiteral( "Pose" ), QLatin1String( SIGNAL( poseChanged( const Pose& ) ) ) );
 
       return b;
     }
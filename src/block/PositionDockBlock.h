@@ -31,7 +31,7 @@
 #include "BlockBase.h"
 #include "ValueDockBlockBase.h"
 
-#include "../kinematic/PoseOptions.h"
+#include "../kinematic/Pose.h"
 
 class PositionDockBlock : public ValueDockBlockBase {
     Q_OBJECT
@@ -88,7 +88,9 @@ class PositionDockBlock : public ValueDockBlockBase {
       widget->setName( name );
     }
 
-    void setPose( const Point_3& point, const QQuaternion, const PoseOption::Options ) {
+    void setPose( const Pose& pose ) {
+      const Point_3& point = pose.position();
+
       if( wgs84 ) {
         widget->setDescriptions( QStringLiteral( "X" ), QStringLiteral( "Y" ), QStringLiteral( "Z" ) );
       }
@@ -152,7 +154,7 @@ class PositionDockBlockFactory : public BlockFactory {
       }
 
       b->addInputPort( QStringLiteral( "WGS84 Position" ), QLatin1String( SLOT( setWGS84Position( const double, const double, const double ) ) ) );
-      b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Point_3&, const QQuaternion, const PoseOption::Options ) ) ) );
+      b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Pose& ) ) ) );
 
       b->setBrush( QColor( QStringLiteral( "lightsalmon" ) ) );
 
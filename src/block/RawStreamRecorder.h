@@ -0,0 +1,117 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <QObject>
+#include <QByteArray>
+#include <QBasicTimer>
+
+#include "BlockBase.h"
+
+#include "../helpers/IoDeviceThread.h"
+#include "../helpers/RawStreamFormat.h"
+
+// records everything received on the data port to a file, so it can be replayed later with "File Stream"
+// the data is timestamped with a steady clock on reception or with the time given to "Timestamp" before
+// (connect it to "Receive Timestamp" of the source). The file is written by a background thread
+class RawStreamRecorder : public BlockBase {
+    Q_OBJECT
+
+  public:
+    explicit RawStreamRecorder()
+      : BlockBase() {
+      statisticsTimer.start( 1000, this );
+    }
+
+    void emitConfigSignals() override {
+      emit overrunsChanged( 0 );
+      emit bytesWrittenChanged( 0 );
+    }
+
+  signals:
+    void overrunsChanged( const double );
+    void bytesWrittenChanged( const double );
+
+  public slots:
+    void setFilename( const QString& filename ) {
+      writer.close();
+
+      if( !filename.isEmpty() && !writer.open( filename ) ) {
+        qDebug() << "RawStreamRecorder: cannot open" << filename;
+      }
+    }
+
+    // steady clock, seconds
+    void setTimestamp( const double timestamp ) {
+      this->timestamp = qint64( timestamp * 1e9 );
+    }
+
+    void setData( const QByteArray& data ) {
+      if( writer.isOpen() ) {
+        writer.write( timestamp != 0 ? timestamp : IoDeviceThread::now(), data );
+      }
+
+      timestamp = 0;
+    }
+
+  protected:
+    void timerEvent( QTimerEvent* event ) override {
+      if( event->timerId() == statisticsTimer.timerId() ) {
+        emit overrunsChanged( double( writer.overruns ) );
+        emit bytesWrittenChanged( double( writer.bytesWritten ) );
+      }
+    }
+
+  private:
+    RawStream::Writer writer;
+    qint64 timestamp = 0;
+    QBasicTimer statisticsTimer;
+};
+
+class RawStreamRecorderFactory : public BlockFactory {
+    Q_OBJECT
+
+  public:
+    RawStreamRecorderFactory()
+      : BlockFactory() {}
+
+    QString getNameOfFactory() override {
+      return QStringLiteral( "Raw Stream Recorder" );
+    }
+
+    virtual void addToCombobox( QComboBox* combobox ) override {
+      combobox->addItem( getNameOfFactory(), QVariant::fromValue( this ) );
+    }
+
+    virtual QNEBlock* createBlock( QGraphicsScene* scene, int id ) override {
+      auto* obj = new RawStreamRecorder();
+      auto* b = createBaseBlock( scene, obj, id );
+
+      b->addInputPort( QStringLiteral( "File" ), QLatin1String( SLOT( setFilename( const QString& ) ) ) );
+      b->addInputPort( QStringLiteral( "Timestamp" ), QLatin1String( SLOT( setTimestamp( const double ) ) ) );
+      b->addInputPort( QStringLiteral( "Data" ), QLatin1String( SLOT( setData( const QByteArray& ) ) ) );
+
+      b->addOutputPort( QStringLiteral( "Overruns" ), QLatin1String( SIGNAL( overrunsChanged( const double ) ) ) );
+      b->addOutputPort( QStringLiteral( "Bytes Written" ), QLatin1String( SIGNAL( bytesWrittenChanged( const double ) ) ) );
+
+      b->setBrush( QColor( QStringLiteral( "gold" ) ) );
+
+      return b;
+    }
+};
@@ -24,55 +24,80 @@
 
 #include "BlockBase.h"
 
+#include "../helpers/IoDeviceThread.h"
+
 class SerialPort : public BlockBase {
     Q_OBJECT
 
   public:
     explicit SerialPort()
       : BlockBase() {
-      serialPort = new QSerialPort( this );
-      connect( serialPort, &QIODevice::readyRead,
-               this, &SerialPort::processPendingData );
+      // owned by ioDeviceThread
+      serialPort = new QSerialPort();
+
+      ioDeviceThread = new IoDeviceThread( serialPort, [this]( IoDeviceThread::Chunk & chunk ) {
+        const qint64 bytesAvailable = serialPort->bytesAvailable();
+
+        if( bytesAvailable <= 0 ) {
+          return false;
+        }
+
+        chunk.data.resize( int( bytesAvailable ) );
+        chunk.data.resize( int( qMax( serialPort->read( chunk.data.data(), chunk.data.size() ), qint64( 0 ) ) ) );
+        return true;
+      }, this );
+
+      connect( ioDeviceThread, &IoDeviceThread::dataReceived, this, &SerialPort::dataReceived );
+      connect( ioDeviceThread, &IoDeviceThread::latencyChanged, this, &SerialPort::latencyChanged );
+      connect( ioDeviceThread, &IoDeviceThread::overrunsChanged, this, &SerialPort::overrunsChanged );
+      connect( ioDeviceThread, &IoDeviceThread::bytesPerSecondChanged, this, &SerialPort::bytesPerSecondChanged );
     }
 
     ~SerialPort() {
-      if( serialPort ) {
-        serialPort->deleteLater();
-      }
+      // moves the serial port back to this thread and deletes it
+      delete ioDeviceThread;
+    }
+
+    // the device follows the block, if it doesn't run in its own thread
+    bool canMoveToControlThread() const override {
+      return true;
     }
 
     void emitConfigSignals() override {
     }
 
   signals:
-    void  dataReceived( const QByteArray& );
+    void dataReceived( const QByteArray& );
+
+    void latencyChanged( const double );
+    void overrunsChanged( const double );
+    void bytesPerSecondChanged( const double );
 
   public slots:
     void setPort( const QString& port ) {
       this->port = port;
-      serialPort->close();
-      serialPort->setPortName( port );
-      serialPort->open( QIODevice::ReadWrite );
+      ioDeviceThread->invoke( [this, port] {
+        serialPort->close();
+        serialPort->setPortName( port );
+        serialPort->open( QIODevice::ReadWrite );
+      } );
     }
 
     void setBaudrate( double baudrate ) {
       this->baudrate = baudrate;
-      serialPort->setBaudRate( qint32( baudrate ) );
+      ioDeviceThread->invoke( [this, baudrate] {
+        serialPort->setBaudRate( qint32( baudrate ) );
+      } );
     }
 
-    void sendData( const QByteArray& data ) {
-      serialPort->write( data );
+    void setOwnThread( double ownThread ) {
+      ioDeviceThread->setThreaded( !qFuzzyIsNull( ownThread ) );
     }
 
-  protected slots:
-    void processPendingData() {
-      QByteArray datagram;
-
-      while( serialPort->bytesAvailable() ) {
-        datagram.resize( int( serialPort->bytesAvailable() ) );
-        serialPort->read( datagram.data(), datagram.size() );
-        emit dataReceived( datagram );
-      }
+    void sendData( const QByteArray& data ) {
+      ioDeviceThread->invoke( [this, data] {
+        serialPort->write( data );
+      } );
     }
 
   public:
@@ -81,6 +106,7 @@ class SerialPort : public BlockBase {
 
   private:
     QSerialPort* serialPort = nullptr;
+    IoDeviceThread* ioDeviceThread = nullptr;
 };
 
 class SerialPortFactory : public BlockFactory {
@@ -104,9 +130,13 @@ class SerialPortFactory : public BlockFactory {
 
       b->addInputPort( QStringLiteral( "Port" ), QLatin1String( SLOT( setPort( QString ) ) ) );
       b->addInputPort( QStringLiteral( "Baudrate" ), QLatin1String( SLOT( setBaudrate( double ) ) ) );
+      b->addInputPort( QStringLiteral( "Own Thread" ), QLatin1String( SLOT( setOwnThread( double ) ) ) );
       b->addInputPort( QStringLiteral( "Data" ), QLatin1String( SLOT( sendData( const QByteArray& ) ) ) );
 
       b->addOutputPort( QStringLiteral( "Data" ), QLatin1String( SIGNAL( dataReceived( const QByteArray& ) ) ) );
+      b->addOutputPort( QStringLiteral( "Latency" ), QLatin1String( SIGNAL( latencyChanged( const double ) ) ) );
+      b->addOutputPort( QStringLiteral( "Overruns" ), QLatin1String( SIGNAL( overrunsChanged( const double ) ) ) );
+      b->addOutputPort( QStringLiteral( "Bytes/s" ), QLatin1String( SIGNAL( bytesPerSecondChanged( const double ) ) ) );
 
       b->setBrush( QColor( QStringLiteral( "cornflowerblue" ) ) );
 
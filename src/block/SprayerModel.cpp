@@ -40,10 +40,10 @@ SprayerModel::~SprayerModel() {
   m_rootEntity->deleteLater();
 }
 
-void SprayerModel::setPose( const Point_3& position, const QQuaternion rotation, const PoseOption::Options options ) {
-  if( !options.testFlag( PoseOption::CalculateLocalOffsets ) ) {
-    m_rootEntityTransform->setTranslation( convertPoint3ToQVector3D( position ) );
-    m_rootEntityTransform->setRotation( rotation );
+void SprayerModel::setPose( const Pose& pose ) {
+  if( !pose.options().testFlag( PoseOption::CalculateLocalOffsets ) ) {
+    m_rootEntityTransform->setTranslation( convertPoint3ToQVector3D( pose.position() ) );
+    m_rootEntityTransform->setRotation( pose.orientation() );
   }
 }
 
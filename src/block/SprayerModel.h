@@ -32,7 +32,7 @@
 
 #include "../cgalKernel.h"
 
-#include "../kinematic/PoseOptions.h"
+#include "../kinematic/Pose.h"
 
 #include "../block/Implement.h"
 
@@ -44,7 +44,7 @@ class SprayerModel : public BlockBase {
     ~SprayerModel();
 
   public slots:
-    void setPose( const Point_3&, const QQuaternion, const PoseOption::Options );
+    void setPose( const Pose& );
     void setImplement( const QPointer<Implement>& );
     void setSections();
     void setHeight( double );
@@ -94,7 +94,7 @@ class SprayerModelFactory : public BlockFactory {
       auto* obj = new SprayerModel( rootEntity );
       auto* b = createBaseBlock( scene, obj, id );
 
-      b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Point_3&, const QQuaternion, const PoseOption::Options ) ) ) );
+      b->addInputPort( QStringLiteral( "Pose" ), QLatin1String( SLOT( setPose( const Pose& ) ) ) );
       b->addInputPort( QStringLiteral( "Height" ), QLatin1String( SLOT( setHeight( double ) ) ) );
       b->addInputPort( QStringLiteral( "Implement Data" ), QLatin1String( SLOT( setImplement( const QPointer<Implement> ) ) ) );
       b->addInputPort( QStringLiteral( "Section Control Data" ), QLatin1String( SLOT( setSections() ) ) );
@@ -35,6 +35,10 @@ class StringObject : public BlockBase {
       emit stringChanged( string );
     }
 
+    QVariant constantValue() const override {
+      return QVariant( string );
+    }
+
     void toJSON( QJsonObject& json ) override {
       QJsonObject valuesObject;
       valuesObject[QStringLiteral( "String" )] = string;
@@ -233,23 +233,23 @@ void TrailerModel::setTrackwidth( double trackwidth ) {
   }
 }
 
-void TrailerModel::setPoseTowPoint( const Point_3& position, const QQuaternion, const PoseOption::Options options ) {
-  if( !options.testFlag( PoseOption::CalculateLocalOffsets ) ) {
-    m_towPointTransform->setTranslation( convertPoint3ToQVector3D( position ) );
+void TrailerModel::setPoseTowPoint( const Pose& pose ) {
+  if( !pose.options().testFlag( PoseOption::CalculateLocalOffsets ) ) {
+    m_towPointTransform->setTranslation( convertPoint3ToQVector3D( pose.position() ) );
   }
 }
 
-void TrailerModel::setPoseHookPoint( const Point_3& position, const QQuaternion, const PoseOption::Options options ) {
-  if( !options.testFlag( PoseOption::CalculateLocalOffsets ) ) {
-    m_towHookTransform->setTranslation( convertPoint3ToQVector3D( position ) );
+void TrailerModel::setPoseHookPoint( const Pose& pose ) {
+  if( !pose.options().testFlag( PoseOption::CalculateLocalOffsets ) ) {
+    m_towHookTransform->setTranslation( convertPoint3ToQVector3D( pose.position() ) );
   }
 }
 
-void TrailerModel::setPosePivotPoint( const Point_3& position, const QQuaternion rotation, const PoseOption::Options options ) {
-  if( !options.testFlag( PoseOption::CalculateLocalOffsets ) ) {
-    m_pivotPointTransform->setTranslation( convertPoint3ToQVector3D( position ) );
+void TrailerModel::setPosePivotPoint( const Pose& pose ) {
+  if( !pose.options().testFlag( PoseOption::CalculateLocalOffsets ) ) {
+    m_pivotPointTransform->setTranslation( convertPoint3ToQVector3D( pose.position() ) );
 
-    m_rootEntityTransform->setTranslation( convertPoint3ToQVector3D( position ) );
-    m_rootEntityTransform->setRotation( rotation );
+    m_rootEntityTransform->setTranslation( convertPoint3ToQVector3D( pose.position() ) );
+    m_rootEntityTransform->setRotation( pose.orientation() );
   }
 }
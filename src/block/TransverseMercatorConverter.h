@@ -56,6 +56,10 @@ class TransverseMercatorConverter : public BlockBase {
     void positionChanged( const Point_3& );
 
   public:
+    bool canMoveToControlThread() const override {
+      return true;
+    }
+
     virtual void emitConfigSignals() override {
       auto dummyPoint = Point_3( 0, 0, 0 );
       emit positionChanged( dummyPoint );
@@ -22,87 +22,17 @@
 
 #include "BlockBase.h"
 
-#include "UBX_Parser.h"
-
-class UBX_Parser_Helper : public QObject, public UBX_Parser {
-    Q_OBJECT
-
-  public:
-    UBX_Parser_Helper() {}
-    ~UBX_Parser_Helper() {}
-
-  protected:
-    void handle_NAV_HPPOSLLH(
-            uint32_t iTOW,
-            double lon,
-            double lat,
-            double height,
-            double hMSL,
-            uint32_t hAcc,
-            uint32_t vAcc ) override {
-      emit ubxNavHpPosLlhChanged( iTOW, lon, lat, height, hMSL, hAcc, vAcc );
-    }
-
-    void handle_NAV_RELPOSNED(
-            uint32_t iTOW,
-            double relPosN,
-            double relPosE,
-            double relPosD,
-            double relPosLenght,
-            double relPosHeading ) override {
-      emit ubxNavRelPosNedChanged( iTOW, relPosN, relPosE, relPosD, relPosLenght, relPosHeading );
-    }
-
-    void handle_NAV_PVT(
-            uint32_t iTOW,
-            bool rtkFix,
-            bool rtkFloat,
-            uint8_t numSatelites,
-            double speed,
-            double headingOfMotion,
-            double headingOfVehicle,
-            double pDOP ) override {
-      emit UbxNavPvtChanged( iTOW, rtkFix, rtkFloat, numSatelites, speed, headingOfMotion, headingOfVehicle, pDOP );
-    }
-
-  signals:
-    void ubxNavHpPosLlhChanged(
-            uint32_t iTOW,
-            double lon,
-            double lat,
-            double height,
-            double hMSL,
-            uint32_t hAcc,
-            uint32_t vAcc );
-
-    void ubxNavRelPosNedChanged(
-            uint32_t iTOW,
-            double relPosN,
-            double relPosE,
-            double relPosD,
-            double relPosLenght,
-            double relPosHeading );
-
-    void UbxNavPvtChanged(
-            uint32_t iTOW,
-            bool rtkFix,
-            bool rtkFloat,
-            uint8_t numSatelites,
-            double speed,
-            double headingOfMotion,
-            double headingOfVehicle,
-            double pDOP );
-};
+#include "../helpers/UbxFramer.h"
 
 class UbxParser : public BlockBase {
     Q_OBJECT
 
   public:
     explicit UbxParser()
-      : BlockBase() {
-      connect( &ubxParser, &UBX_Parser_Helper::ubxNavHpPosLlhChanged, this, &UbxParser::ubxNavHpPosLLH );
-      connect( &ubxParser, &UBX_Parser_Helper::ubxNavRelPosNedChanged, this, &UbxParser::ubxNavRelPosNed );
-      connect( &ubxParser, &UBX_Parser_Helper::UbxNavPvtChanged, this, &UbxParser::UbxNavPvt );
+      : BlockBase() {}
+
+    bool canMoveToControlThread() const override {
+      return true;
     }
 
   signals:
@@ -118,34 +48,83 @@ class UbxParser : public BlockBase {
     void horizontalAccuracyChanged( const double );
     void verticalAccuracyChanged( const double );
 
+    // time of week of the last navigation solution in seconds
+    void towChanged( const double );
+
   public slots:
     void setData( const QByteArray& data ) {
-      for( const char c : data ) {
-        ubxParser.parse( c );
+      ubxFramer.parse( data, [this]( const UbxFramer::Message & message ) {
+        if( message.is( Ubx::MessageClass::Nav, Ubx::NavMessageId::HpPosLlh ) ) {
+          Ubx::NavHpPosLlh navHpPosLlh;
+
+          if( message.decode( navHpPosLlh ) ) {
+            ubxNavHpPosLLH( navHpPosLlh );
+          }
+        } else if( message.is( Ubx::MessageClass::Nav, Ubx::NavMessageId::RelPosNed ) ) {
+          Ubx::NavRelPosNed navRelPosNed;
+
+          if( message.decode( navRelPosNed ) ) {
+            ubxNavRelPosNed( navRelPosNed );
+          }
+        } else if( message.is( Ubx::MessageClass::Nav, Ubx::NavMessageId::Pvt ) ) {
+          Ubx::NavPvt navPvt;
+
+          if( message.decode( navPvt ) ) {
+            ubxNavPvt( navPvt );
+          }
+        }
+      } );
+    }
+
+    void setHeadingOffset( const double headingOffset ) {
+      this->headingOffset = headingOffset;
+    }
+    void setHeadingFactor( const double headingFactor ) {
+      this->headingFactor = headingFactor;
+    }
+
+    void setRollOffset( const double rollOffset ) {
+      this->rollOffset = rollOffset;
+    }
+    void setRollFactor( const double rollFactor ) {
+      this->rollFactor = rollFactor;
+    }
+
+  private:
+    void setTow( const uint32_t iTOW ) {
+      // the receiver sends multiple messages per epoch with the same iTOW
+      if( iTOW != lastITOW ) {
+        lastITOW = iTOW;
+        emit towChanged( double( iTOW ) / 1000 );
       }
     }
 
-  protected slots:
-    void ubxNavHpPosLLH(
-            uint32_t /*iTOW*/,
-            double lon,
-            double lat,
-            double height,
-            double /*hMSL*/,
-            uint32_t hAcc,
-            uint32_t vAcc ) {
-      emit globalPositionChanged( lon, lat, height );
-      emit horizontalAccuracyChanged( hAcc );
-      emit verticalAccuracyChanged( vAcc );
+    void ubxNavHpPosLLH( const Ubx::NavHpPosLlh& navHpPosLlh ) {
+      // bit 0 of flags: invalid lon, lat, height and hMSL
+      if( ( navHpPosLlh.flags & 0x01 ) != 0 ) {
+        return;
+      }
+
+      setTow( navHpPosLlh.iTOW );
+
+      // add the high precision parts: lon/lat in 1e-9 deg, height in 0.1 mm
+      double lon = ( double( navHpPosLlh.lon ) * 100 + navHpPosLlh.lonHp ) * 1e-9;
+      double lat = ( double( navHpPosLlh.lat ) * 100 + navHpPosLlh.latHp ) * 1e-9;
+      double height = ( double( navHpPosLlh.height ) * 10 + navHpPosLlh.heightHp ) * 1e-4;
+
+      emit globalPositionChanged( lat, lon, height );
+      emit horizontalAccuracyChanged( double( navHpPosLlh.hAcc ) * 1e-4 );
+      emit verticalAccuracyChanged( double( navHpPosLlh.vAcc ) * 1e-4 );
     }
 
-    void ubxNavRelPosNed(
-            uint32_t /*iTOW*/,
-            double /*relPosN*/,
-            double /*relPosE*/,
-            double relPosD,
-            double relPosLenght,
-            double relPosHeading ) {
+    void ubxNavRelPosNed( const Ubx::NavRelPosNed& navRelPosNed ) {
+      setTow( navRelPosNed.iTOW );
+
+      // cm + 0.1 mm -> m
+      double relPosD = ( double( navRelPosNed.relPosD ) * 100 + navRelPosNed.relPosHPD ) * 1e-4;
+      double relPosLenght = ( double( navRelPosNed.relPosLength ) * 100 + navRelPosNed.relPosHPLength ) * 1e-4;
+      double relPosHeading = double( navRelPosNed.relPosHeading ) * 1e-5;
+
       emit orientationDualAntennaChanged(
               // roll
               QQuaternion::fromAxisAndAngle(
@@ -159,45 +138,26 @@ class UbxParser : public BlockBase {
       );
     }
 
-    void UbxNavPvt(
-            uint32_t /*iTOW*/,
-            bool /*rtkFix*/,
-            bool /*rtkFloat*/,
-            uint8_t numSatelites,
-            double speed,
-            double headingOfMotion,
-            double headingOfVehicle,
-            double pDOP ) {
+    void ubxNavPvt( const Ubx::NavPvt& navPvt ) {
+      setTow( navPvt.iTOW );
 
-      emit velocityChanged( speed );
-      emit numSatelitesChanged( numSatelites );
-      emit hdopChanged( pDOP );
+      emit velocityChanged( double( navPvt.gSpeed ) / 1000 );
+      emit numSatelitesChanged( navPvt.numSV );
+      emit hdopChanged( double( navPvt.pDOP ) / 100 );
 
       emit orientationMotionChanged( QQuaternion::fromAxisAndAngle(
                                              QVector3D( 0.0f, 0.0f, 1.0f ),
-                                             float( ( headingOfMotion - headingOffset )*headingFactor ) ) );
+                                             float( ( double( navPvt.headMot ) * 1e-5 - headingOffset )*headingFactor ) ) );
 
       emit orientationVehicleChanged( QQuaternion::fromAxisAndAngle(
                                               QVector3D( 0.0f, 0.0f, 1.0f ),
-                                              float( ( headingOfVehicle - headingOffset )*headingFactor ) ) );
-    }
-
-    void setHeadingOffset( const double headingOffset ) {
-      this->headingOffset = headingOffset;
-    }
-    void setHeadingFactor( const double headingFactor ) {
-      this->headingFactor = headingFactor;
-    }
-
-    void setRollOffset( const double rollOffset ) {
-      this->rollOffset = rollOffset;
-    }
-    void setRollFactor( const double rollFactor ) {
-      this->rollFactor = rollFactor;
+                                              float( ( double( navPvt.headVeh ) * 1e-5 - headingOffset )*headingFactor ) ) );
     }
 
   private:
-    UBX_Parser_Helper ubxParser;
+    UbxFramer ubxFramer;
+    uint32_t lastITOW = 0;
+
     double headingOffset = 0;
     double rollOffset = 0;
     double headingFactor = 0;
@@ -239,6 +199,7 @@ class UbxParserFactory : public BlockFactory {
       b->addOutputPort( QStringLiteral( "HDOP" ), QLatin1String( SIGNAL( hdopChanged( const double ) ) ) );
       b->addOutputPort( QStringLiteral( "Horizontal Accuracy" ), QLatin1String( SIGNAL( horizontalAccuracyChanged( const double ) ) ) );
       b->addOutputPort( QStringLiteral( "Vertical Accuracy" ), QLatin1String( SIGNAL( verticalAccuracyChanged( const double ) ) ) );
+      b->addOutputPort( QStringLiteral( "TOW" ), QLatin1String( SIGNAL( towChanged( const double ) ) ) );
 
       b->setBrush( QColor( QStringLiteral( "mediumaquamarine" ) ) );
 
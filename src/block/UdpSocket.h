@@ -23,47 +23,138 @@
 
 #include "BlockBase.h"
 
+#include "../helpers/IoDeviceThread.h"
+#include "../helpers/DatagramBatchReceiver.h"
+#include "../helpers/LatencyHistogram.h"
+
 class UdpSocket : public BlockBase {
     Q_OBJECT
 
   public:
     explicit UdpSocket()
       : BlockBase() {
-      udpSocket = new QUdpSocket( this );
-      connect( udpSocket, &QIODevice::readyRead,
-               this, &UdpSocket::processPendingDatagrams );
+      // owned by ioDeviceThread
+      udpSocket = new QUdpSocket();
+
+      ioDeviceThread = new IoDeviceThread( udpSocket, [this]( IoDeviceThread::Chunk & chunk ) {
+        if( batchedReceive ) {
+          return batchReceiver.read( chunk );
+        }
+
+        if( !udpSocket->hasPendingDatagrams() ) {
+          return false;
+        }
+
+        chunk.data.resize( int( udpSocket->pendingDatagramSize() ) );
+        chunk.data.resize( int( qMax( udpSocket->readDatagram( chunk.data.data(), chunk.data.size() ), qint64( 0 ) ) ) );
+        return true;
+      }, this );
+
+      connect( ioDeviceThread, &IoDeviceThread::timestampChanged, this, &UdpSocket::timestampChanged );
+      connect( ioDeviceThread, &IoDeviceThread::dataReceived, this, &UdpSocket::dataReceived );
+      connect( ioDeviceThread, &IoDeviceThread::latencyChanged, this, &UdpSocket::latencyChanged );
+      connect( ioDeviceThread, &IoDeviceThread::overrunsChanged, this, &UdpSocket::overrunsChanged );
+      connect( ioDeviceThread, &IoDeviceThread::bytesPerSecondChanged, this, &UdpSocket::bytesPerSecondChanged );
+
+      ageOfData = new LatencyStatistics( this );
+      connect( ageOfData, &LatencyStatistics::latencyChanged, this, &UdpSocket::ageOfDataChanged );
+      connect( ageOfData, &LatencyStatistics::p50Changed, this, &UdpSocket::ageOfDataP50Changed );
+      connect( ageOfData, &LatencyStatistics::p99Changed, this, &UdpSocket::ageOfDataP99Changed );
+      connect( ageOfData, &LatencyStatistics::maxChanged, this, &UdpSocket::ageOfDataMaxChanged );
     }
 
     ~UdpSocket() {
-      if( udpSocket ) {
-        udpSocket->deleteLater();
-      }
+      // moves the socket back to this thread and deletes it
+      delete ioDeviceThread;
+    }
+
+    // the device follows the block, if it doesn't run in its own thread
+    bool canMoveToControlThread() const override {
+      return true;
     }
 
     void emitConfigSignals() override {
     }
 
   signals:
+    void timestampChanged( const double );
     void dataReceived( const QByteArray& );
 
+    void latencyChanged( const double );
+    void overrunsChanged( const double );
+    void bytesPerSecondChanged( const double );
+
+    // age of the sent datagrams in ms, emitted once a second
+    void ageOfDataChanged( const double, const double, const double );
+    void ageOfDataP50Changed( const double );
+    void ageOfDataP99Changed( const double );
+    void ageOfDataMaxChanged( const double );
+
   public slots:
     void setPort( double port ) {
       this->port = port;
-      udpSocket->bind( quint16( port ),  QUdpSocket::DontShareAddress );
+      ioDeviceThread->invoke( [this, port = quint16( port )] {
+        bind( port );
+      } );
     }
 
-    void sendData( const QByteArray& data ) {
-      udpSocket->writeDatagram( data, QHostAddress::Broadcast, port );
+    // receives all pending datagrams with one syscall and uses the receive timestamps of the kernel; linux only
+    void setBatchedReceive( double batchedReceive ) {
+      ioDeviceThread->invoke( [this, batchedReceive, port = quint16( port )] {
+        const bool enabled = DatagramBatchReceiver::isAvailable() && !qFuzzyIsNull( batchedReceive );
+
+        if( this->batchedReceive != enabled ) {
+          this->batchedReceive = enabled;
+          bind( port );
+        }
+      } );
+    }
+
+    // sends the data to this address instead of broadcasting it; an empty string restores broadcasting
+    void setSendAddress( const QString& sendAddress ) {
+      QHostAddress address = sendAddress.isEmpty() ? QHostAddress( QHostAddress::Broadcast ) : QHostAddress( sendAddress );
+
+      if( address.isNull() ) {
+        qWarning() << "UdpSocket: invalid address" << sendAddress;
+        return;
+      }
+
+      ioDeviceThread->invoke( [this, address] {
+        this->sendAddress = address;
+      } );
     }
 
-  protected slots:
-    void processPendingDatagrams() {
-      QByteArray datagram;
+    void setOwnThread( double ownThread ) {
+      ioDeviceThread->setThreaded( !qFuzzyIsNull( ownThread ) );
+    }
 
-      while( udpSocket->hasPendingDatagrams() ) {
-        datagram.resize( int( udpSocket->pendingDatagramSize() ) );
-        udpSocket->readDatagram( datagram.data(), datagram.size() );
-        emit dataReceived( datagram );
+    void sendData( const QByteArray& data ) {
+      ageOfData->record();
+      ioDeviceThread->invoke( [this, data, port = quint16( port )] {
+        udpSocket->writeDatagram( data, sendAddress, port );
+      } );
+    }
+
+  private:
+    // called on the thread of the socket
+    void bind( const quint16 port ) {
+      udpSocket->close();
+      delete batchNotifier;
+      batchNotifier = nullptr;
+      batchReceiver.close();
+
+      if( batchedReceive ) {
+        // the batch receiver gets the port and its own notifier; the udp socket is only used to send
+        if( batchReceiver.bind( port ) ) {
+          batchNotifier = new QSocketNotifier( batchReceiver.getSocketDescriptor(), QSocketNotifier::Read, udpSocket );
+          // the signature of activated() changed over the Qt versions, activated( int ) is in all of them
+          connect( batchNotifier, SIGNAL( activated( int ) ),
+                   ioDeviceThread, SLOT( readFromDevice() ), Qt::DirectConnection );
+        } else {
+          qWarning() << "UdpSocket: can't bind port" << port << "for batched receive";
+        }
+      } else {
+        udpSocket->bind( port, QUdpSocket::DontShareAddress );
       }
     }
 
@@ -72,6 +163,14 @@ class UdpSocket : public BlockBase {
 
   private:
     QUdpSocket* udpSocket = nullptr;
+    IoDeviceThread* ioDeviceThread = nullptr;
+    LatencyStatistics* ageOfData = nullptr;
+
+    // only accessed on the thread of the socket
+    DatagramBatchReceiver batchReceiver;
+    QSocketNotifier* batchNotifier = nullptr;
+    bool batchedReceive = false;
+    QHostAddress sendAddress = QHostAddress( QHostAddress::Broadcast );
 };
 
 class UdpSocketFactory : public BlockFactory {
@@ -94,9 +193,20 @@ class UdpSocketFactory : public BlockFactory {
       auto* b = createBaseBlock( scene, obj, id );
 
       b->addInputPort( QStringLiteral( "Port" ), QLatin1String( SLOT( setPort( double ) ) ) );
+      b->addInputPort( QStringLiteral( "Own Thread" ), QLatin1String( SLOT( setOwnThread( double ) ) ) );
+      b->addInputPort( QStringLiteral( "Batched Receive" ), QLatin1String( SLOT( setBatchedReceive( double ) ) ) );
+      b->addInputPort( QStringLiteral( "Send Address" ), QLatin1String( SLOT( setSendAddress( const QString& ) ) ) );
       b->addInputPort( QStringLiteral( "Data" ), QLatin1String( SLOT( sendData( const QByteArray& ) ) ) );
 
       b->addOutputPort( QStringLiteral( "Data" ), QLatin1String( SIGNAL( dataReceived( const QByteArray& ) ) ) );
+      b->addOutputPort( QStringLiteral( "Receive Timestamp" ), QLatin1String( SIGNAL( timestampChanged( const double ) ) ) );
+      b->addOutputPort( QStringLiteral( "Latency" ), QLatin1String( SIGNAL( latencyChanged( const double ) ) ) );
+      b->addOutputPort( QStringLiteral( "Overruns" ), QLatin1String( SIGNAL( overrunsChanged( const double ) ) ) );
+      b->addOutputPort( QStringLiteral( "Bytes/s" ), QLatin1String( SIGNAL( bytesPerSecondChanged( const double ) ) ) );
+      b->addOutputPort( QStringLiteral( "Age of Data" ), QLatin1String( SIGNAL( ageOfDataChanged( const double, const double, const double ) ) ) );
+      b->addOutputPort( QStringLiteral( "Age of Data p50" ), QLatin1String( SIGNAL( ageOfDataP50Changed( const double ) ) ) );
+      b->addOutputPort( QStringLiteral( "Age of Data p99" ), QLatin1String( SIGNAL( ageOfDataP99Changed( const double ) ) ) );
+      b->addOutputPort( QStringLiteral( "Age of Data Max" ), QLatin1String( SIGNAL( ageOfDataMaxChanged( const double ) ) ) );
 
       b->setBrush( QColor( QStringLiteral( "cornflowerblue" ) ) );
 
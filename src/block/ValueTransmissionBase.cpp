@@ -17,6 +17,49 @@
 // along with this program.  If not, see < https : //www.gnu.org/licenses/>.
 
 #include "ValueTransmissionBase.h"
+#include "ValueTransmissionDemux.h"
+
+ValueTransmissionBase::~ValueTransmissionBase() {
+  if( demux ) {
+    demux->unsubscribe( this );
+  }
+}
+
+void ValueTransmissionBase::setTransmissionId( int id ) {
+  this->id = id;
+  updateFrameHeader();
+
+  if( demux ) {
+    demux->subscribe( this );
+  }
+}
+
+void ValueTransmissionBase::setDemux( QObject* object ) {
+  auto* demux = qobject_cast<ValueTransmissionDemux*>( object );
+
+  if( this->demux && this->demux != demux ) {
+    this->demux->unsubscribe( this );
+  }
+
+  this->demux = demux;
+
+  if( demux ) {
+    demux->subscribe( this );
+  }
+}
+
+void ValueTransmissionBase::sendLastFrame() {
+  if( demux ) {
+    // the old receivers only decode a single map, not a batch
+    if( legacyFormat ) {
+      demux->transmitUnbatched( lastFrame );
+    } else {
+      demux->transmit( id, lastFrame );
+    }
+  } else {
+    emit dataToSend( lastFrame );
+  }
+}
 
 void ValueTransmissionBase::timerEvent( QTimerEvent* event ) {
   if( event->timerId() == timeoutTimer.timerId() ) {
@@ -19,24 +19,70 @@
 #pragma once
 
 #include <QObject>
+#include <QPointer>
+#include <QCborMap>
+#include <QCborArray>
+#include <QCborValue>
+#include <QCborStreamReader>
 
 #include "BlockBase.h"
 
+#include "../helpers/CborEncoder.h"
+#include "../helpers/SimulationClock.h"
+
+class ValueTransmissionDemux;
+
+// the frames are CBOR maps with integer keys: { 0: channel id, 2: format version, 1: payload }
+// the map header, the channel id and the version are encoded once per channel, so only the payload is encoded on
+// sending. Frames of other versions are dropped. The old format with text keys ("channelId", "number", ...) and
+// base64 encoded data can still be decoded, and is sent with "Legacy Format" set for receivers that only know it
+
 class ValueTransmissionBase : public BlockBase {
     Q_OBJECT
 
+    friend class ValueTransmissionDemux;
+
+  public:
+    enum FrameKey : qint64 {
+      ChannelIdKey = 0,
+      PayloadKey = 1,
+      FormatKey = 2
+    };
+
+    // the version of the compact format, sent in every frame
+    enum : qint64 {
+      FormatVersion = 1
+    };
+
   public:
     explicit ValueTransmissionBase( const int id )
-      : BlockBase(), id( id ) {}
+      : BlockBase(), id( id ) {
+      updateFrameHeader();
+    }
+
+    // the channel id of a frame in either format; not an integer if it has none
+    static QCborValue channelIdOf( const QCborMap& frame ) {
+      if( frame.contains( qint64( ChannelIdKey ) ) ) {
+        return frame.value( qint64( ChannelIdKey ) );
+      }
 
-    virtual ~ValueTransmissionBase() {
+      return frame.value( QStringLiteral( "channelId" ) );
     }
 
+    // false for the frames of another version of the compact format
+    static bool isSupportedFormat( const QCborMap& frame ) {
+      return !frame.contains( qint64( FormatKey ) ) ||
+             frame.value( qint64( FormatKey ) ).toInteger( -1 ) == qint64( FormatVersion );
+    }
+
+    virtual ~ValueTransmissionBase();
+
     void toJSON( QJsonObject& json ) override {
       QJsonObject valuesObject;
       valuesObject[QStringLiteral( "id" )] = id;
       valuesObject[QStringLiteral( "timeoutTimeMs" )] = timeoutTimeMs;
       valuesObject[QStringLiteral( "repeatTimeMs" )] = repeatTimeMs;
+      valuesObject[QStringLiteral( "legacyFormat" )] = legacyFormat;
       json[QStringLiteral( "values" )] = valuesObject;
     }
 
@@ -45,7 +91,7 @@ class ValueTransmissionBase : public BlockBase {
         QJsonObject valuesObject = json[QStringLiteral( "values" )].toObject();
 
         if( valuesObject[QStringLiteral( "id" )].isDouble() ) {
-          id = valuesObject[QStringLiteral( "id" )].toInt();
+          setTransmissionId( valuesObject[QStringLiteral( "id" )].toInt() );
         }
 
         if( valuesObject[QStringLiteral( "timeoutTimeMs" )].isDouble() ) {
@@ -53,7 +99,11 @@ class ValueTransmissionBase : public BlockBase {
         }
 
         if( valuesObject[QStringLiteral( "repeatTimeMs" )].isDouble() ) {
-          repeatTimeMs = valuesObject[QStringLiteral( "repeatTimeMs" )].toInt();
+          setRepeatTimeMs( valuesObject[QStringLiteral( "repeatTimeMs" )].toInt() );
+        }
+
+        if( valuesObject[QStringLiteral( "legacyFormat" )].isBool() ) {
+          legacyFormat = valuesObject[QStringLiteral( "legacyFormat" )].toBool();
         }
       }
     }
@@ -64,31 +114,128 @@ class ValueTransmissionBase : public BlockBase {
     }
     void setRepeatTimeMs( int value ) {
       repeatTimeMs = value;
+
+      if( repeatTimeMs <= 0 ) {
+        repeatTimer.stop();
+      }
+    }
+
+    void setTransmissionId( int id );
+
+    // sends the frames in the old format with text keys, for receivers that don't know the compact one
+    void setLegacyFormat( double legacyFormat ) {
+      this->legacyFormat = !qFuzzyIsNull( legacyFormat );
     }
 
-    void setTransmissionId( int id ) {
-      this->id = id;
+    // decodes the frame and handles it if it is for this channel
+    // with many channels on one link, use a demultiplexer instead, so every frame is decoded only once
+    void dataReceive( const QByteArray& data ) {
+      reader.addData( data );
+
+      auto cbor = QCborValue::fromCbor( reader );
+
+      if( cbor.isMap() ) {
+        handleFrame( cbor.toMap() );
+      } else if( cbor.isArray() ) {
+        // a batch of frames
+        const auto frames = cbor.toArray();
+
+        for( const QCborValue& item : frames ) {
+          if( item.isMap() ) {
+            handleFrame( item.toMap() );
+          }
+        }
+      }
     }
 
+    // a ValueTransmissionDemux; subscribes this block to it
+    void setDemux( QObject* object );
+
   signals:
     void timedOut( int id );
+    void dataToSend( const QByteArray& );
 
   protected:
     void timerEvent( QTimerEvent* event ) override;
     void resetTimeout() {
       timeoutTimer.start( timeoutTimeMs, this );
     }
+
+    // returns the pre-encoded header of the frames of this channel; append the payload and pass it to transmit()
+    QByteArray beginFrame( const int payloadSize ) const {
+      QByteArray frame;
+      frame.reserve( frameHeader.size() + payloadSize );
+      frame.append( frameHeader );
+      return frame;
+    }
+
+    // sends the frame and repeats it every repeatTimeMs until the next one
+    // if subscribed to a demultiplexer, the frame is sent batched with the other channels by it
+    void transmit( QByteArray&& frame ) {
+      lastFrame = std::move( frame );
+      sendLastFrame();
+
+      if( repeatTimeMs > 0 ) {
+        repeatTimer.start( repeatTimeMs, this );
+      }
+    }
+
+    // sends the frame in the old format: the channel id is added to it
+    void transmit( QCborMap&& legacyFrame ) {
+      legacyFrame[QStringLiteral( "channelId" )] = id;
+      transmit( legacyFrame.toCborValue().toCbor() );
+    }
+
     virtual void retransmit() {
+      if( !lastFrame.isEmpty() ) {
+        sendLastFrame();
+      }
+    }
+
+    // called with the decoded frames of this channel, in either format
+    virtual void frameReceived( const QCborMap& frame ) = 0;
 
+    // the payload of a frame in the compact format or the value with the given key in the old format
+    static QCborValue payloadOf( const QCborMap& frame, const QString& oldKey ) {
+      if( frame.contains( qint64( PayloadKey ) ) ) {
+        return frame.value( qint64( PayloadKey ) );
+      }
+
+      return frame.value( oldKey );
     }
 
   public:
     int id = 0;
     int timeoutTimeMs = 1000;
     int repeatTimeMs = 0;
+    bool legacyFormat = false;
 
   private:
-    QBasicTimer timeoutTimer;
-    QBasicTimer repeatTimer;
-};
+    void sendLastFrame();
+
+    void handleFrame( const QCborMap& frame ) {
+      if( isSupportedFormat( frame ) && channelIdOf( frame ) == id ) {
+        frameReceived( frame );
+      }
+    }
 
+    void updateFrameHeader() {
+      frameHeader.clear();
+      CborEncoder::appendMapHeader( frameHeader, 3 );
+      CborEncoder::appendInteger( frameHeader, ChannelIdKey );
+      CborEncoder::appendInteger( frameHeader, id );
+      CborEncoder::appendInteger( frameHeader, FormatKey );
+      CborEncoder::appendInteger( frameHeader, FormatVersion );
+      CborEncoder::appendInteger( frameHeader, PayloadKey );
+    }
+
+  private:
+    SimulationTimer timeoutTimer;
+    SimulationTimer repeatTimer;
+
+    QCborStreamReader reader;
+    QPointer<ValueTransmissionDemux> demux;
+
+    QByteArray frameHeader;
+    QByteArray lastFrame;
+};
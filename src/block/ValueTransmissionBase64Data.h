@@ -32,29 +32,33 @@ class ValueTransmissionBase64Data : public ValueTransmissionBase {
 
   public slots:
     void setData( const QByteArray& data ) {
-      QCborMap map;
-      map[QStringLiteral( "channelId" )] = id;
-      map[QStringLiteral( "data" )] = QString(data.toBase64(QByteArray::OmitTrailingEquals));
-
-      emit dataToSend( QCborValue( std::move( map ) ).toCbor() );
-    }
-
-    void dataReceive( const QByteArray& data ) {
-      reader.addData( data );
+      if( legacyFormat ) {
+        QCborMap map;
+        map[QStringLiteral( "data" )] = QString( data.toBase64( QByteArray::OmitTrailingEquals ) );
+        transmit( std::move( map ) );
+        return;
+      }
 
-      auto cbor = QCborValue::fromCbor( reader );
+      // sent as a byte string; only the old format used base64
+      auto frame = beginFrame( data.size() + 9 );
+      CborEncoder::appendByteString( frame, data );
 
-      if( cbor.isMap() && ( cbor[QStringLiteral( "channelId" )] == id ) ) {
-        emit dataChanged( QByteArray::fromBase64(cbor[QStringLiteral( "data" )].toByteArray()) );
-      }
+      transmit( std::move( frame ) );
     }
 
   signals:
-    void dataToSend( const QByteArray& );
     void dataChanged( const QByteArray& );
 
-  private:
-    QCborStreamReader reader;
+  protected:
+    void frameReceived( const QCborMap& frame ) override {
+      const auto payload = payloadOf( frame, QStringLiteral( "data" ) );
+
+      if( payload.isByteArray() ) {
+        emit dataChanged( payload.toByteArray() );
+      } else if( payload.isString() ) {
+        emit dataChanged( QByteArray::fromBase64( payload.toString().toLatin1() ) );
+      }
+    }
 };
 
 class ValueTransmissionBase64DataFactory : public BlockFactory {
@@ -82,6 +86,9 @@ class ValueTransmissionBase64DataFactory : public BlockFactory {
       b->addInputPort( QStringLiteral( "In" ), QLatin1String( SLOT( setData( const QByteArray& ) ) ), false );
       b->addOutputPort( QStringLiteral( "CBOR Out" ), QLatin1String( SIGNAL( dataToSend( const QByteArray& ) ) ), false );
 
+      b->addInputPort( QStringLiteral( "CBOR Demux" ), QLatin1String( SLOT( setDemux( QObject* ) ) ) );
+      b->addInputPort( QStringLiteral( "Legacy Format" ), QLatin1String( SLOT( setLegacyFormat( double ) ) ) );
+
       b->setBrush( QColor( QStringLiteral( "lightblue" ) ) );
 
       return b;
@@ -0,0 +1,308 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <QObject>
+#include <QHash>
+#include <QVector>
+#include <QMetaMethod>
+#include <QCborMap>
+#include <QCborValue>
+#include <QCborArray>
+
+#include <algorithm>
+
+#include "BlockBase.h"
+#include "ValueTransmissionBase.h"
+
+#include "../helpers/CborEncoder.h"
+#include "../helpers/SimulationClock.h"
+
+// decodes every CBOR frame once and hands it to the value transmission blocks subscribed to its channel
+// connect "Channels" to "CBOR Demux" of the value transmission blocks instead of connecting every one of them
+// to the data source.
+// In the other direction, the frames sent by the subscribed blocks within "Cycle Time" are packed into one
+// CBOR array, so only one packet per cycle is sent. Only the latest frame of every channel is kept.
+// Receivers that only know the legacy format can't decode a batch: the frames of the blocks with "Legacy Format"
+// set are sent on their own
+class ValueTransmissionDemux : public BlockBase {
+    Q_OBJECT
+
+  public:
+    explicit ValueTransmissionDemux()
+      : BlockBase() {
+      statisticsTimer.start( 1000, this );
+    }
+
+    void emitConfigSignals() override {
+      emit demuxChanged( this );
+      emitStatistics();
+    }
+
+    // queues the encoded frame of a channel for the next batch
+    void transmit( const int channelId, const QByteArray& frame ) {
+      auto it = pendingFrameOfChannel.constFind( channelId );
+
+      if( it != pendingFrameOfChannel.cend() ) {
+        pendingFrames[it.value()] = frame;
+      } else {
+        pendingFrameOfChannel.insert( channelId, int( pendingFrames.size() ) );
+        pendingFrames.append( frame );
+      }
+
+      if( cycleTimeMs <= 0 || pendingFrames.size() >= MaxFramesPerBatch ) {
+        sendBatch();
+      } else if( !batchTimer.isActive() ) {
+        batchTimer.start( cycleTimeMs, this );
+      }
+    }
+
+    // sends the encoded frame of a channel now, as a packet of its own
+    void transmitUnbatched( const QByteArray& frame ) {
+      emit dataToSend( frame );
+      ++packetsSent;
+    }
+
+    void subscribe( ValueTransmissionBase* subscriber ) {
+      unsubscribe( subscriber );
+      channels[subscriber->id].subscribers.append( subscriber );
+    }
+
+    void unsubscribe( ValueTransmissionBase* subscriber ) {
+      for( auto& channel : channels ) {
+        channel.subscribers.removeAll( subscriber );
+      }
+    }
+
+  signals:
+    void demuxChanged( QObject* );
+    void dataToSend( const QByteArray& );
+    void packetsSentChanged( const double );
+    void framesChanged( const double );
+    void unknownChannelFramesChanged( const double );
+    void decodeErrorsChanged( const double );
+    // "<channel id>: <frames>" for every channel seen
+    void statisticsChanged( const QString& );
+
+  public slots:
+    void setCycleTimeMs( const double cycleTimeMs ) {
+      this->cycleTimeMs = int( cycleTimeMs );
+
+      if( this->cycleTimeMs <= 0 ) {
+        sendBatch();
+      }
+    }
+
+    void dataReceive( const QByteArray& data ) {
+      QCborParserError error;
+      const auto cbor = QCborValue::fromCbor( data, &error );
+
+      if( error.error != QCborError::NoError ) {
+        ++decodeErrors;
+        return;
+      }
+
+      if( cbor.isMap() ) {
+        dispatch( cbor.toMap() );
+      } else if( cbor.isArray() ) {
+        // a batch of frames
+        const auto frames = cbor.toArray();
+
+        for( const QCborValue& frame : frames ) {
+          if( frame.isMap() ) {
+            dispatch( frame.toMap() );
+          } else {
+            ++decodeErrors;
+          }
+        }
+      } else {
+        ++decodeErrors;
+      }
+    }
+
+  private slots:
+    // the subscribers still connected subscribe again, the others send their frames on their own again
+    void resubscribe() {
+      for( auto& channel : channels ) {
+        for( auto* subscriber : qAsConst( channel.subscribers ) ) {
+          subscriber->demux = nullptr;
+        }
+
+        channel.subscribers.clear();
+      }
+
+      emit demuxChanged( this );
+    }
+
+  protected:
+    // there is no way to know which block was disconnected, so start over
+    void disconnectNotify( const QMetaMethod& signal ) override {
+      if( signal == QMetaMethod::fromSignal( &ValueTransmissionDemux::demuxChanged ) ) {
+        QMetaObject::invokeMethod( this, "resubscribe", Qt::QueuedConnection );
+      }
+    }
+
+    void timerEvent( QTimerEvent* event ) override {
+      if( event->timerId() == statisticsTimer.timerId() ) {
+        emitStatistics();
+      }
+
+      if( event->timerId() == batchTimer.timerId() ) {
+        sendBatch();
+      }
+    }
+
+  private:
+    void sendBatch() {
+      batchTimer.stop();
+
+      if( pendingFrames.isEmpty() ) {
+        return;
+      }
+
+      // a single frame is sent as before, so receivers without batch support still understand it
+      if( pendingFrames.size() == 1 ) {
+        emit dataToSend( pendingFrames.first() );
+      } else {
+        // the frames are already encoded, so only the header of the array has to be added
+        int size = 9;
+
+        for( const auto& frame : qAsConst( pendingFrames ) ) {
+          size += frame.size();
+        }
+
+        QByteArray batch;
+        batch.reserve( size );
+        CborEncoder::appendArrayHeader( batch, quint64( pendingFrames.size() ) );
+
+        for( const auto& frame : qAsConst( pendingFrames ) ) {
+          batch.append( frame );
+        }
+
+        emit dataToSend( batch );
+      }
+
+      ++packetsSent;
+
+      pendingFrames.clear();
+      pendingFrameOfChannel.clear();
+    }
+
+    void dispatch( const QCborMap& frame ) {
+      const auto channelId = ValueTransmissionBase::channelIdOf( frame );
+
+      if( !channelId.isInteger() || !ValueTransmissionBase::isSupportedFormat( frame ) ) {
+        ++decodeErrors;
+        return;
+      }
+
+      ++frames;
+
+      auto& channel = channels[int( channelId.toInteger() )];
+      ++channel.frames;
+
+      if( channel.subscribers.isEmpty() ) {
+        ++unknownChannelFrames;
+      }
+
+      // a copy, as the subscribers can (un)subscribe while handling the frame
+      const auto subscribers = channel.subscribers;
+
+      for( auto* subscriber : subscribers ) {
+        subscriber->frameReceived( frame );
+      }
+    }
+
+    void emitStatistics() {
+      emit framesChanged( double( frames ) );
+      emit unknownChannelFramesChanged( double( unknownChannelFrames ) );
+      emit decodeErrorsChanged( double( decodeErrors ) );
+      emit packetsSentChanged( double( packetsSent ) );
+
+      auto ids = channels.keys();
+      std::sort( ids.begin(), ids.end() );
+
+      QString statistics;
+
+      for( const auto id : qAsConst( ids ) ) {
+        statistics += QStringLiteral( "%1: %2\n" ).arg( id ).arg( channels[id].frames );
+      }
+
+      emit statisticsChanged( statistics );
+    }
+
+  private:
+    static constexpr int MaxFramesPerBatch = 32;
+
+    struct Channel {
+      QVector<ValueTransmissionBase*> subscribers;
+      quint64 frames = 0;
+    };
+
+    QHash<int, Channel> channels;
+
+    quint64 frames = 0;
+    quint64 unknownChannelFrames = 0;
+    quint64 decodeErrors = 0;
+    quint64 packetsSent = 0;
+
+    int cycleTimeMs = 20;
+    QVector<QByteArray> pendingFrames;
+    // index into pendingFrames
+    QHash<int, int> pendingFrameOfChannel;
+
+    SimulationTimer statisticsTimer;
+    SimulationTimer batchTimer;
+};
+
+class ValueTransmissionDemuxFactory : public BlockFactory {
+    Q_OBJECT
+
+  public:
+    ValueTransmissionDemuxFactory()
+      : BlockFactory() {}
+
+    QString getNameOfFactory() override {
+      return QStringLiteral( "Value Transmit Demultiplexer" );
+    }
+
+    virtual void addToCombobox( QComboBox* combobox ) override {
+      combobox->addItem( getNameOfFactory(), QVariant::fromValue( this ) );
+    }
+
+    virtual QNEBlock* createBlock( QGraphicsScene* scene, int id ) override {
+      auto* obj = new ValueTransmissionDemux();
+      auto* b = createBaseBlock( scene, obj, id );
+
+      b->addInputPort( QStringLiteral( "Cycle Time" ), QLatin1String( SLOT( setCycleTimeMs( const double ) ) ) );
+      b->addInputPort( QStringLiteral( "CBOR In" ), QLatin1String( SLOT( dataReceive( const QByteArray& ) ) ) );
+
+      b->addOutputPort( QStringLiteral( "Channels" ), QLatin1String( SIGNAL( demuxChanged( QObject* ) ) ) );
+      b->addOutputPort( QStringLiteral( "CBOR Out" ), QLatin1String( SIGNAL( dataToSend( const QByteArray& ) ) ) );
+      b->addOutputPort( QStringLiteral( "Packets Sent" ), QLatin1String( SIGNAL( packetsSentChanged( const double ) ) ) );
+      b->addOutputPort( QStringLiteral( "Frames" ), QLatin1String( SIGNAL( framesChanged( const double ) ) ) );
+      b->addOutputPort( QStringLiteral( "Unknown Channel" ), QLatin1String( SIGNAL( unknownChannelFramesChanged( const double ) ) ) );
+      b->addOutputPort( QStringLiteral( "Decode Errors" ), QLatin1String( SIGNAL( decodeErrorsChanged( const double ) ) ) );
+      b->addOutputPort( QStringLiteral( "Statistics" ), QLatin1String( SIGNAL( statisticsChanged( const QString& ) ) ) );
+
+      b->setBrush( QColor( QStringLiteral( "lightblue" ) ) );
+
+      return b;
+    }
+};
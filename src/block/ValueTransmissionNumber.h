@@ -32,29 +32,26 @@ class ValueTransmissionNumber : public ValueTransmissionBase {
 
   public slots:
     void setNumber( const double number ) {
-      QCborMap map;
-      map[QStringLiteral( "channelId" )] = id;
-      map[QStringLiteral( "number" )] = number;
-
-      emit dataToSend( QCborValue( std::move( map ) ).toCbor() );
-    }
-
-    void dataReceive( const QByteArray& data ) {
-      reader.addData( data );
+      if( legacyFormat ) {
+        QCborMap map;
+        map[QStringLiteral( "number" )] = number;
+        transmit( std::move( map ) );
+        return;
+      }
 
-      auto cbor = QCborValue::fromCbor( reader );
+      auto frame = beginFrame( 9 );
+      CborEncoder::appendDouble( frame, number );
 
-      if( cbor.isMap() && ( cbor[QStringLiteral( "channelId" )] == id ) ) {
-        emit numberChanged( cbor[QStringLiteral( "number" )].toDouble( 0 ) );
-      }
+      transmit( std::move( frame ) );
     }
 
   signals:
-    void dataToSend( const QByteArray& );
     void numberChanged( const double );
 
-  private:
-    QCborStreamReader reader;
+  protected:
+    void frameReceived( const QCborMap& frame ) override {
+      emit numberChanged( payloadOf( frame, QStringLiteral( "number" ) ).toDouble( 0 ) );
+    }
 };
 
 class ValueTransmissionNumberFactory : public BlockFactory {
@@ -82,6 +79,9 @@ class ValueTransmissionNumberFactory : public BlockFactory {
       b->addInputPort( QStringLiteral( "In" ), QLatin1String( SLOT( setNumber( const double ) ) ), false );
       b->addOutputPort( QStringLiteral( "CBOR Out" ), QLatin1String( SIGNAL( dataToSend( const QByteArray& ) ) ), false );
 
+      b->addInputPort( QStringLiteral( "CBOR Demux" ), QLatin1String( SLOT( setDemux( QObject* ) ) ) );
+      b->addInputPort( QStringLiteral( "Legacy Format" ), QLatin1String( SLOT( setLegacyFormat( double ) ) ) );
+
       b->setBrush( QColor( QStringLiteral( "lightblue" ) ) );
 
       return b;
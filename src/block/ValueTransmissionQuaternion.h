@@ -32,38 +32,50 @@ class ValueTransmissionQuaternion : public ValueTransmissionBase {
 
   public slots:
     void setQuaternion( const QQuaternion quaternion ) {
-      QCborMap map;
-      map[QStringLiteral( "channelId" )] = id;
-      map[QStringLiteral( "x" )] = quaternion.x();
-      map[QStringLiteral( "y" )] = quaternion.y();
-      map[QStringLiteral( "z" )] = quaternion.z();
-      map[QStringLiteral( "w" )] = quaternion.scalar();
-
-      emit dataToSend( QCborValue( std::move( map ) ).toCbor() );
-    }
+      if( legacyFormat ) {
+        QCborMap map;
+        map[QStringLiteral( "x" )] = quaternion.x();
+        map[QStringLiteral( "y" )] = quaternion.y();
+        map[QStringLiteral( "z" )] = quaternion.z();
+        map[QStringLiteral( "w" )] = quaternion.scalar();
+        transmit( std::move( map ) );
+        return;
+      }
 
-    void dataReceive( const QByteArray& data ) {
-      reader.addData( data );
+      // [w, x, y, z]
+      auto frame = beginFrame( 1 + 4 * 5 );
+      CborEncoder::appendArrayHeader( frame, 4 );
+      CborEncoder::appendFloat( frame, quaternion.scalar() );
+      CborEncoder::appendFloat( frame, quaternion.x() );
+      CborEncoder::appendFloat( frame, quaternion.y() );
+      CborEncoder::appendFloat( frame, quaternion.z() );
 
-      auto cbor = QCborValue::fromCbor( reader );
+      transmit( std::move( frame ) );
+    }
 
-      if( cbor.isMap() && ( cbor[QStringLiteral( "channelId" )] == id ) ) {
+  signals:
+    void quaternionChanged( const QQuaternion );
 
-        auto x = cbor[QStringLiteral( "x" )].toDouble( 0 );
-        auto y = cbor[QStringLiteral( "y" )].toDouble( 0 );
-        auto z = cbor[QStringLiteral( "z" )].toDouble( 0 );
-        auto w = cbor[QStringLiteral( "w" )].toDouble( 0 );
+  protected:
+    void frameReceived( const QCborMap& frame ) override {
+      if( frame.contains( qint64( PayloadKey ) ) ) {
+        const auto payload = frame.value( qint64( PayloadKey ) ).toArray();
+
+        if( payload.size() == 4 ) {
+          emit quaternionChanged( QQuaternion( float( payload.at( 0 ).toDouble( 0 ) ),
+                                               float( payload.at( 1 ).toDouble( 0 ) ),
+                                               float( payload.at( 2 ).toDouble( 0 ) ),
+                                               float( payload.at( 3 ).toDouble( 0 ) ) ) );
+        }
+      } else {
+        auto x = frame[QStringLiteral( "x" )].toDouble( 0 );
+        auto y = frame[QStringLiteral( "y" )].toDouble( 0 );
+        auto z = frame[QStringLiteral( "z" )].toDouble( 0 );
+        auto w = frame[QStringLiteral( "w" )].toDouble( 0 );
 
         emit quaternionChanged( QQuaternion( float( w ), float( x ), float( y ), float( z ) ) );
       }
     }
-
-  signals:
-    void dataToSend( const QByteArray& );
-    void quaternionChanged( const QQuaternion );
-
-  private:
-    QCborStreamReader reader;
 };
 
 class ValueTransmissionQuaternionFactory : public BlockFactory {
@@ -91,6 +103,9 @@ class ValueTransmissionQuaternionFactory : public BlockFactory {
       b->addInputPort( QStringLiteral( "In" ), QLatin1String( SLOT( setQuaternion( const QQuaternion ) ) ), false );
       b->addOutputPort( QStringLiteral( "CBOR Out" ), QLatin1String( SIGNAL( dataToSend( const QByteArray& ) ) ), false );
 
+      b->addInputPort( QStringLiteral( "CBOR Demux" ), QLatin1String( SLOT( setDemux( QObject* ) ) ) );
+      b->addInputPort( QStringLiteral( "Legacy Format" ), QLatin1String( SLOT( setLegacyFormat( double ) ) ) );
+
       b->setBrush( QColor( QStringLiteral( "lightblue" ) ) );
 
       return b;
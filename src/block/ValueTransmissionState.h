@@ -32,29 +32,26 @@ class ValueTransmissionState : public ValueTransmissionBase {
 
   public slots:
     void setState( const bool state ) {
-      QCborMap map;
-      map[QStringLiteral( "channelId" )] = id;
-      map[QStringLiteral( "state" )] = state;
-
-      emit dataToSend( QCborValue( std::move( map ) ).toCbor() );
-    }
-
-    void dataReceive( const QByteArray& data ) {
-      reader.addData( data );
+      if( legacyFormat ) {
+        QCborMap map;
+        map[QStringLiteral( "state" )] = state;
+        transmit( std::move( map ) );
+        return;
+      }
 
-      auto cbor = QCborValue::fromCbor( reader );
+      auto frame = beginFrame( 1 );
+      CborEncoder::appendBool( frame, state );
 
-      if( cbor.isMap() && ( cbor[QStringLiteral( "channelId" )] == id ) ) {
-        emit stateChanged( cbor[QStringLiteral( "state" )].toBool( false ) );
-      }
+      transmit( std::move( frame ) );
     }
 
   signals:
-    void dataToSend( const QByteArray& );
     void stateChanged( const bool );
 
-  private:
-    QCborStreamReader reader;
+  protected:
+    void frameReceived( const QCborMap& frame ) override {
+      emit stateChanged( payloadOf( frame, QStringLiteral( "state" ) ).toBool( false ) );
+    }
 };
 
 class ValueTransmissionStateFactory : public BlockFactory {
@@ -82,6 +79,9 @@ class ValueTransmissionStateFactory : public BlockFactory {
       b->addInputPort( QStringLiteral( "In" ), QLatin1String( SLOT( setState( const bool ) ) ), false );
       b->addOutputPort( QStringLiteral( "CBOR Out" ), QLatin1String( SIGNAL( dataToSend( const QByteArray& ) ) ), false );
 
+      b->addInputPort( QStringLiteral( "CBOR Demux" ), QLatin1String( SLOT( setDemux( QObject* ) ) ) );
+      b->addInputPort( QStringLiteral( "Legacy Format" ), QLatin1String( SLOT( setLegacyFormat( double ) ) ) );
+
       b->setBrush( QColor( QStringLiteral( "lightblue" ) ) );
 
       return b;
@@ -38,6 +38,10 @@ class VectorObject : public BlockBase {
       emit vectorChanged( vector );
     }
 
+    QVariant constantValue() const override {
+      return QVariant( vector );
+    }
+
     void toJSON( QJsonObject& json ) override {
       QJsonObject valuesObject;
       valuesObject[QStringLiteral( "X" )] = double( vector.x() );
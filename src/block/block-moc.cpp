@@ -34,6 +34,8 @@
 #include "moc_GuidanceXte.cpp"
 #include "moc_Implement.cpp"
 #include "moc_ImplementSection.cpp"
+#include "moc_LatencyDockBlock.cpp"
+#include "moc_NmeaParserBase.cpp"
 #include "moc_NmeaParserGGA.cpp"
 #include "moc_NmeaParserHDT.cpp"
 #include "moc_NmeaParserRMC.cpp"
@@ -43,6 +45,7 @@
 #include "moc_PoseSynchroniser.cpp"
 #include "moc_PositionDockBlock.cpp"
 #include "moc_PrintLatency.cpp"
+#include "moc_RawStreamRecorder.cpp"
 #include "moc_SprayerModel.cpp"
 #include "moc_StringObject.cpp"
 #include "moc_TractorModel.cpp"
@@ -54,6 +57,7 @@
 #include "moc_ValueDockBlock.cpp"
 #include "moc_ValueTransmissionBase.cpp"
 #include "moc_ValueTransmissionBase64Data.cpp"
+#include "moc_ValueTransmissionDemux.cpp"
 #include "moc_ValueTransmissionNumber.cpp"
 #include "moc_ValueTransmissionQuaternion.cpp"
 #include "moc_ValueTransmissionState.cpp"
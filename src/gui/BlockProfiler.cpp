@@ -0,0 +1,321 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#include "BlockProfiler.h"
+
+#include <QMetaObject>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QtMath>
+
+#include <QtCore/private/qobject_p.h>
+
+#include <chrono>
+
+#include "../qnodeseditor/qneblock.h"
+#include "../qnodeseditor/qneport.h"
+
+namespace {
+  struct Frame {
+    const QObject* object;
+    int methodIndex;
+    BlockProfiler::Counters* block;
+    BlockProfiler::Counters* port;
+    qint64 start;
+    qint64 childNs;
+  };
+
+  // the slots currently running on this thread
+  thread_local std::vector<Frame> frames;
+
+  qint64 now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch() ).count();
+  }
+
+  QSignalSpyCallbackSet callbacks = { nullptr, nullptr, nullptr, nullptr };
+}
+
+BlockProfiler& BlockProfiler::instance() {
+  static BlockProfiler profiler;
+  return profiler;
+}
+
+void BlockProfiler::start( QGraphicsScene* scene ) {
+  this->scene = scene;
+
+  auto newRegistry = std::make_unique<Registry>();
+
+  const auto& constRefOfList = scene->items();
+
+  for( const auto& item : constRefOfList ) {
+    auto* block = qgraphicsitem_cast<QNEBlock*>( item );
+
+    if( block != nullptr && block->object != nullptr ) {
+      auto entry = std::make_unique<Block>();
+      entry->block = block;
+
+      const QMetaObject* metaObject = block->object->metaObject();
+      const auto& childItems = block->childItems();
+
+      for( const auto& childItem : childItems ) {
+        auto* port = qgraphicsitem_cast<QNEPort*>( childItem );
+
+        if( port != nullptr && !port->isOutput() && port->slotSignalSignature.size() > 1 ) {
+          // the signatures are from SLOT(), so skip the code in the first character
+          const int methodIndex = metaObject->indexOfMethod(
+                                    QMetaObject::normalizedSignature( port->slotSignalSignature.latin1() + 1 ).constData() );
+
+          if( methodIndex >= 0 ) {
+            entry->portStorage.push_back( std::make_unique<Port>() );
+            entry->portStorage.back()->name = port->getName();
+            entry->ports.insert( methodIndex, entry->portStorage.back().get() );
+          }
+        }
+      }
+
+      newRegistry->blocksByObject.insert( block->object, entry.get() );
+      newRegistry->blocks.push_back( std::move( entry ) );
+    }
+  }
+
+  registry.store( newRegistry.get() );
+  registries.push_back( std::move( newRegistry ) );
+
+  if( !running ) {
+    callbacks.slot_begin_callback = &BlockProfiler::slotBegin;
+    callbacks.slot_end_callback = &BlockProfiler::slotEnd;
+    qt_register_signal_spy_callbacks( &callbacks );
+    running = true;
+  }
+}
+
+void BlockProfiler::stop() {
+  if( running ) {
+    qt_register_signal_spy_callbacks( nullptr );
+    running = false;
+  }
+}
+
+void BlockProfiler::reset() {
+  Registry* currentRegistry = registry.load();
+
+  if( currentRegistry != nullptr ) {
+    for( const auto& block : currentRegistry->blocks ) {
+      block->counters.reset();
+
+      for( const auto& port : block->portStorage ) {
+        port->counters.reset();
+      }
+    }
+  }
+}
+
+void BlockProfiler::slotBegin( QObject* caller, int methodIndex, void** ) {
+  const Registry* currentRegistry = instance().registry.load( std::memory_order_acquire );
+
+  if( currentRegistry != nullptr ) {
+    Block* block = currentRegistry->blocksByObject.value( caller, nullptr );
+
+    if( block != nullptr ) {
+      Port* port = block->ports.value( methodIndex, nullptr );
+      frames.push_back( Frame{ caller, methodIndex, &block->counters, port != nullptr ? &port->counters : nullptr, now(), 0 } );
+    }
+  }
+}
+
+void BlockProfiler::slotEnd( QObject* caller, int methodIndex ) {
+  // calls of objects not profiled never got a frame
+  if( frames.empty() || frames.back().object != caller || frames.back().methodIndex != methodIndex ) {
+    return;
+  }
+
+  const Frame frame = frames.back();
+  frames.pop_back();
+
+  const qint64 elapsed = now() - frame.start;
+  const qint64 self = elapsed - frame.childNs;
+
+  frame.block->calls.fetch_add( 1, std::memory_order_relaxed );
+  frame.block->totalNs.fetch_add( elapsed, std::memory_order_relaxed );
+  frame.block->selfNs.fetch_add( self, std::memory_order_relaxed );
+
+  if( frame.port != nullptr ) {
+    frame.port->calls.fetch_add( 1, std::memory_order_relaxed );
+    frame.port->totalNs.fetch_add( elapsed, std::memory_order_relaxed );
+    frame.port->selfNs.fetch_add( self, std::memory_order_relaxed );
+  }
+
+  if( !frames.empty() ) {
+    frames.back().childNs += elapsed;
+  }
+}
+
+QSet<const QNEBlock*> BlockProfiler::blocksInScene() const {
+  QSet<const QNEBlock*> blocks;
+
+  if( !scene.isNull() ) {
+    const auto& constRefOfList = scene->items();
+
+    for( const auto& item : constRefOfList ) {
+      auto* block = qgraphicsitem_cast<QNEBlock*>( item );
+
+      if( block != nullptr ) {
+        blocks.insert( block );
+      }
+    }
+  }
+
+  return blocks;
+}
+
+bool BlockProfiler::updateHeat() {
+  const Registry* currentRegistry = registry.load();
+
+  if( currentRegistry == nullptr ) {
+    return true;
+  }
+
+  const auto blocks = blocksInScene();
+
+  if( size_t( blocks.size() ) != currentRegistry->blocks.size() ) {
+    return false;
+  }
+
+  qint64 maxSelfNs = 0;
+
+  for( const auto& block : currentRegistry->blocks ) {
+    if( !blocks.contains( block->block ) ) {
+      return false;
+    }
+
+    maxSelfNs = qMax( maxSelfNs, block->counters.selfNs.load() );
+  }
+
+  for( const auto& block : currentRegistry->blocks ) {
+    const quint64 calls = block->counters.calls.load();
+    const qint64 selfNs = block->counters.selfNs.load();
+    const qint64 totalNs = block->counters.totalNs.load();
+
+    block->block->setHeat( maxSelfNs > 0 ? qreal( selfNs ) / qreal( maxSelfNs ) : 0 );
+    block->block->setToolTip( QStringLiteral( "%1 calls\ntotal: %2 ms\nself: %3 ms\nmean: %4 µs" )
+                              .arg( calls )
+                              .arg( double( totalNs ) / 1e6, 0, 'f', 3 )
+                              .arg( double( selfNs ) / 1e6, 0, 'f', 3 )
+                              .arg( calls != 0 ? double( totalNs ) / double( calls ) / 1e3 : 0., 0, 'f', 1 ) );
+  }
+
+  return true;
+}
+
+void BlockProfiler::clearHeat() {
+  const Registry* currentRegistry = registry.load();
+
+  if( currentRegistry != nullptr ) {
+    const auto blocks = blocksInScene();
+
+    for( const auto& block : currentRegistry->blocks ) {
+      if( blocks.contains( block->block ) ) {
+        block->block->setHeat( -1 );
+        block->block->setToolTip( QString() );
+      }
+    }
+  }
+}
+
+QString BlockProfiler::toCsv() const {
+  QString csv = QStringLiteral( "id,block,type,port,calls,total_ms,self_ms\n" );
+
+  const Registry* currentRegistry = registry.load();
+
+  if( currentRegistry != nullptr ) {
+    auto addLine = [&csv]( const Block & block, const QString & port, const Counters & counters ) {
+      // quote the names, they are entered by the user
+      auto quoted = []( QString string ) {
+        return QStringLiteral( "\"" ) + string.replace( QLatin1Char( '"' ), QLatin1String( "\"\"" ) ) + QStringLiteral( "\"" );
+      };
+
+      csv += QStringLiteral( "%1,%2,%3,%4,%5,%6,%7\n" )
+             .arg( block.block->id )
+             .arg( quoted( block.block->getName() ), quoted( block.block->typeString ), quoted( port ) )
+             .arg( counters.calls.load() )
+             .arg( double( counters.totalNs.load() ) / 1e6, 0, 'f', 6 )
+             .arg( double( counters.selfNs.load() ) / 1e6, 0, 'f', 6 );
+    };
+
+    const auto blocks = blocksInScene();
+
+    for( const auto& block : currentRegistry->blocks ) {
+      if( !blocks.contains( block->block ) ) {
+        continue;
+      }
+
+      addLine( *block, QString(), block->counters );
+
+      for( const auto& port : block->portStorage ) {
+        addLine( *block, port->name, port->counters );
+      }
+    }
+  }
+
+  return csv;
+}
+
+QJsonDocument BlockProfiler::toJson() const {
+  auto countersToJson = []( QJsonObject & object, const Counters & counters ) {
+    object[QStringLiteral( "calls" )] = double( counters.calls.load() );
+    object[QStringLiteral( "totalMs" )] = double( counters.totalNs.load() ) / 1e6;
+    object[QStringLiteral( "selfMs" )] = double( counters.selfNs.load() ) / 1e6;
+  };
+
+  QJsonArray blocks;
+
+  const Registry* currentRegistry = registry.load();
+
+  if( currentRegistry != nullptr ) {
+    const auto blocksOfScene = blocksInScene();
+
+    for( const auto& block : currentRegistry->blocks ) {
+      if( !blocksOfScene.contains( block->block ) ) {
+        continue;
+      }
+
+      QJsonObject blockObject;
+      blockObject[QStringLiteral( "id" )] = block->block->id;
+      blockObject[QStringLiteral( "name" )] = block->block->getName();
+      blockObject[QStringLiteral( "type" )] = block->block->typeString;
+      countersToJson( blockObject, block->counters );
+
+      QJsonArray ports;
+
+      for( const auto& port : block->portStorage ) {
+        QJsonObject portObject;
+        portObject[QStringLiteral( "name" )] = port->name;
+        countersToJson( portObject, port->counters );
+        ports.append( portObject );
+      }
+
+      blockObject[QStringLiteral( "ports" )] = ports;
+      blocks.append( blockObject );
+    }
+  }
+
+  QJsonObject jsonObject;
+  jsonObject[QStringLiteral( "blocks" )] = blocks;
+  return QJsonDocument( jsonObject );
+}
@@ -0,0 +1,111 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <QString>
+#include <QPointer>
+#include <QHash>
+#include <QSet>
+#include <QJsonDocument>
+#include <QGraphicsScene>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+class QObject;
+class QNEBlock;
+
+// counts the calls and measures the wall time of the slots of the blocks, per block and per input port.
+// It hooks into the signal spy callbacks of Qt, which are called for every slot invoked by a signal; if the
+// profiler is stopped, they are unregistered and cost nothing. Nested calls are added to the total time of
+// the caller, but not to its self time. Queued calls (to the control thread) are not measured
+class BlockProfiler {
+  public:
+    struct Counters {
+      std::atomic<quint64> calls{0};
+      std::atomic<qint64> totalNs{0};
+      std::atomic<qint64> selfNs{0};
+
+      void reset() {
+        calls = 0;
+        totalNs = 0;
+        selfNs = 0;
+      }
+    };
+
+    struct Port {
+      QString name;
+      Counters counters;
+    };
+
+    struct Block {
+      QNEBlock* block = nullptr;
+      Counters counters;
+
+      // by the method index of the slot of the port
+      QHash<int, Port*> ports;
+      std::vector<std::unique_ptr<Port>> portStorage;
+    };
+
+  public:
+    static BlockProfiler& instance();
+
+    // registers all the blocks of the scene and starts profiling; restarts with the new scene if already running
+    void start( QGraphicsScene* scene );
+    void stop();
+
+    bool isRunning() const {
+      return running;
+    }
+
+    void reset();
+
+    // colours the blocks by their share of the self time and sets a tooltip with the numbers
+    // returns false if blocks were added or deleted since starting; restart the profiler in this case
+    bool updateHeat();
+    void clearHeat();
+
+    QString toCsv() const;
+    QJsonDocument toJson() const;
+
+  private:
+    BlockProfiler() = default;
+
+    // never changed after creation, as the callbacks read it from every thread without locking
+    struct Registry {
+      QHash<const QObject*, Block*> blocksByObject;
+      std::vector<std::unique_ptr<Block>> blocks;
+    };
+
+    static void slotBegin( QObject* caller, int methodIndex, void** argv );
+    static void slotEnd( QObject* caller, int methodIndex );
+
+    // the blocks of the registry, that are still in the scene
+    QSet<const QNEBlock*> blocksInScene() const;
+
+  private:
+    QPointer<QGraphicsScene> scene;
+    std::atomic<Registry*> registry{nullptr};
+
+    // the old registries are kept, as a callback on another thread could still use them
+    std::vector<std::unique_ptr<Registry>> registries;
+
+    bool running = false;
+};
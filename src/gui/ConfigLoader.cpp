@@ -0,0 +1,145 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#include "ConfigLoader.h"
+
+#include <QGraphicsScene>
+#include <QJsonArray>
+#include <QDebug>
+
+#include "../qnodeseditor/qneblock.h"
+#include "../qnodeseditor/qneport.h"
+#include "../qnodeseditor/qneconnection.h"
+
+#include "../block/BlockBase.h"
+
+int ConfigLoader::load( const QJsonObject& json ) {
+  idMap.clear();
+  skipped = 0;
+  folded = 0;
+
+  loadBlocks( json );
+  loadConnections( json );
+
+  if( folded != 0 ) {
+    qDebug() << "Config:" << folded << "connections of constant blocks folded";
+  }
+
+  return skipped;
+}
+
+void ConfigLoader::loadBlocks( const QJsonObject& json ) {
+  if( json.contains( QStringLiteral( "blocks" ) ) && json[QStringLiteral( "blocks" )].isArray() ) {
+    QJsonArray blocksArray = json[QStringLiteral( "blocks" )].toArray();
+
+    for( const auto& blockIndex : qAsConst( blocksArray ) ) {
+      QJsonObject blockObject = blockIndex.toObject();
+      int id = blockObject[QStringLiteral( "id" )].toInt( 0 );
+      const QString type = blockObject[QStringLiteral( "type" )].toString();
+
+      // if id is a system-id -> search the block and set the values
+      if( id != 0 ) {
+
+        // system id -> don't create new blocks
+        if( id < int( QNEBlock::IdRange::UserIdStart ) ) {
+          QNEBlock* block = QNEBlock::getBlockWithName( scene, type );
+
+          if( block != nullptr ) {
+            idMap.insert( id, block->id );
+            block->setX( blockObject[QStringLiteral( "positionX" )].toDouble( 0 ) );
+            block->setY( blockObject[QStringLiteral( "positionY" )].toDouble( 0 ) );
+          } else {
+            qWarning() << "Config: system block not available:" << type;
+            ++skipped;
+          }
+
+          // id is not a system-id -> create new blocks
+        } else {
+          auto* factory = factoryForType( type );
+
+          if( factory != nullptr ) {
+            QNEBlock* block = factory->createBlock( scene, id );
+
+            idMap.insert( id, block->id );
+
+            block->setX( blockObject[QStringLiteral( "positionX" )].toDouble( 0 ) );
+            block->setY( blockObject[QStringLiteral( "positionY" )].toDouble( 0 ) );
+            block->setName( blockObject[QStringLiteral( "name" )].toString( factory->getNameOfFactory() ) );
+            block->fromJSON( blockObject );
+            block->setSelected( selectLoadedItems );
+          } else {
+            qWarning() << "Config: no factory for block type:" << type;
+            ++skipped;
+          }
+        }
+      }
+    }
+  }
+}
+
+void ConfigLoader::loadConnections( const QJsonObject& json ) {
+  if( json.contains( QStringLiteral( "connections" ) ) && json[QStringLiteral( "connections" )].isArray() ) {
+    QJsonArray connectionsArray = json[QStringLiteral( "connections" )].toArray();
+
+    for( const auto& connectionsIndex : qAsConst( connectionsArray ) ) {
+      QJsonObject connectionsObject = connectionsIndex.toObject();
+
+      if( !connectionsObject[QStringLiteral( "idFrom" )].isUndefined() &&
+          !connectionsObject[QStringLiteral( "idTo" )].isUndefined() &&
+          !connectionsObject[QStringLiteral( "portFrom" )].isUndefined() &&
+          !connectionsObject[QStringLiteral( "portTo" )].isUndefined() ) {
+
+        int idFrom = idMap.value( connectionsObject[QStringLiteral( "idFrom" )].toInt() );
+        int idTo = idMap.value( connectionsObject[QStringLiteral( "idTo" )].toInt() );
+
+        if( idFrom != 0 && idTo != 0 ) {
+          QNEBlock* blockFrom = QNEBlock::getBlockWithId( scene, idFrom );
+          QNEBlock* blockTo = QNEBlock::getBlockWithId( scene, idTo );
+
+          if( ( blockFrom != nullptr ) && ( blockTo != nullptr ) ) {
+            QString portFromName = connectionsObject[QStringLiteral( "portFrom" )].toString();
+            QString portToName = connectionsObject[QStringLiteral( "portTo" )].toString();
+
+            QNEPort* portFrom = blockFrom->getPortWithName( portFromName, true );
+            QNEPort* portTo = blockTo->getPortWithName( portToName, false );
+
+            if( ( portFrom != nullptr ) && ( portTo != nullptr ) ) {
+              auto* conn = new QNEConnection();
+              conn->setPort1( portFrom );
+
+              if( conn->setPort2( portTo ) ) {
+                blockFrom->scene()->addItem( conn );
+                conn->fromJSON( connectionsObject );
+
+                if( foldConstants && conn->fold() ) {
+                  ++folded;
+                }
+
+                conn->updatePosFromPorts();
+                conn->updatePath();
+                conn->setSelected( selectLoadedItems );
+              } else {
+                delete conn;
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,64 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <QJsonObject>
+#include <QMap>
+#include <QString>
+
+#include <functional>
+
+class QGraphicsScene;
+class BlockFactory;
+
+// loads the blocks and connections saved by SettingsDialog::saveConfigToFile() into a scene.
+// The blocks with a system id already exist and are found by their name, the others are created with
+// the factory returned by the lookup; blocks without a factory are skipped with their connections
+class ConfigLoader {
+  public:
+    using FactoryLookup = std::function<BlockFactory*( const QString& type )>;
+
+    ConfigLoader( QGraphicsScene* scene, FactoryLookup factoryForType )
+      : scene( scene ), factoryForType( std::move( factoryForType ) ) {}
+
+    // returns the number of blocks in the config that couldn't be created
+    int load( const QJsonObject& json );
+
+    // the created blocks and connections are selected, like they are when added by hand
+    bool selectLoadedItems = true;
+
+    // the connections from the blocks with a constant value are taken out of the signal graph; the value is set
+    // directly on the receivers instead, when the blocks emit their config signals
+    bool foldConstants = true;
+
+  private:
+    void loadBlocks( const QJsonObject& json );
+    void loadConnections( const QJsonObject& json );
+
+  private:
+    QGraphicsScene* scene = nullptr;
+    FactoryLookup factoryForType;
+
+    // as the new object get new id, here is a QMap to hold the conversions
+    // first int: id in file, second int: id in the graphicsview
+    QMap<int, int> idMap;
+
+    int skipped = 0;
+    int folded = 0;
+};
@@ -0,0 +1,158 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#include "ExecutionPlan.h"
+
+#include <QGraphicsScene>
+#include <QHash>
+#include <QThread>
+
+#include <algorithm>
+
+#include "../qnodeseditor/qneblock.h"
+#include "../qnodeseditor/qneport.h"
+#include "../qnodeseditor/qneconnection.h"
+
+#include "../block/BlockBase.h"
+
+#include "../cgalKernel.h"
+#include "../kinematic/Pose.h"
+
+void ExecutionPlan::build( QGraphicsScene* scene ) {
+  orderedBlocks.clear();
+  orderedConnections.clear();
+  loopConnections.clear();
+
+  std::vector<QNEBlock*> blocks;
+  std::vector<QNEConnection*> connections;
+
+  const auto& constRefOfList = scene->items();
+
+  for( const auto& item : constRefOfList ) {
+    if( auto* block = qgraphicsitem_cast<QNEBlock*>( item ) ) {
+      blocks.push_back( block );
+    } else if( auto* connection = qgraphicsitem_cast<QNEConnection*>( item ) ) {
+      if( connection->port1() != nullptr && connection->port2() != nullptr ) {
+        connections.push_back( connection );
+      }
+    }
+  }
+
+  // sort by id, so the plan doesn't depend on the order of the items in the scene
+  std::sort( blocks.begin(), blocks.end(), []( const QNEBlock * lhs, const QNEBlock * rhs ) {
+    return lhs->id < rhs->id;
+  } );
+
+  // Kahn's algorithm; port1 of a connection is always the signal
+  QHash<QNEBlock*, int> numIncoming;
+  QHash<QNEBlock*, std::vector<QNEConnection*>> outgoing;
+
+  for( auto* block : blocks ) {
+    numIncoming.insert( block, 0 );
+  }
+
+  for( auto* connection : connections ) {
+    ++numIncoming[connection->port2()->block()];
+    outgoing[connection->port1()->block()].push_back( connection );
+  }
+
+  std::vector<QNEBlock*> ready;
+
+  for( auto* block : blocks ) {
+    if( numIncoming.value( block ) == 0 ) {
+      ready.push_back( block );
+    }
+  }
+
+  QHash<QNEBlock*, bool> done;
+
+  for( size_t i = 0; i < ready.size(); ++i ) {
+    auto* block = ready[i];
+    orderedBlocks.push_back( block );
+    done.insert( block, true );
+
+    for( auto* connection : outgoing.value( block ) ) {
+      orderedConnections.push_back( connection );
+
+      if( --numIncoming[connection->port2()->block()] == 0 ) {
+        ready.push_back( connection->port2()->block() );
+      }
+    }
+  }
+
+  // the remaining blocks are in or behind a loop: add them by id and mark the connections into the plan as
+  // closing a loop
+  for( auto* block : blocks ) {
+    if( !done.contains( block ) ) {
+      orderedBlocks.push_back( block );
+      done.insert( block, true );
+
+      for( auto* connection : outgoing.value( block ) ) {
+        orderedConnections.push_back( connection );
+
+        if( done.contains( connection->port2()->block() ) ) {
+          loopConnections.push_back( connection );
+        }
+      }
+    }
+  }
+}
+
+int ExecutionPlan::moveToControlThread( QThread* thread ) {
+  // the types of the signals crossing the threads have to be known to the meta type system;
+  // Pose is registered in main()
+  qRegisterMetaType<Point_3>( "Point_3" );
+
+  int moved = 0;
+
+  for( auto* block : orderedBlocks ) {
+    auto* blockBase = qobject_cast<BlockBase*>( block->object );
+
+    if( blockBase != nullptr && blockBase->canMoveToControlThread() && blockBase->thread() != thread ) {
+      blockBase->moveToThread( thread );
+      ++moved;
+    }
+  }
+
+  return moved;
+}
+
+int ExecutionPlan::orderConnections() {
+  int failed = 0;
+
+  // the slots of a signal are called in the order they were connected: connect the receivers by their rank in the plan
+  QHash<QNEBlock*, size_t> rank;
+
+  for( size_t i = 0; i < orderedBlocks.size(); ++i ) {
+    rank.insert( orderedBlocks[i], i );
+  }
+
+  std::vector<QNEConnection*> connections = orderedConnections;
+  std::stable_sort( connections.begin(), connections.end(), [&rank]( const QNEConnection * lhs, const QNEConnection * rhs ) {
+    return rank.value( lhs->port2()->block() ) < rank.value( rhs->port2()->block() );
+  } );
+
+  // automatic: a direct call between two blocks on the same thread, queued between the threads
+  for( auto* connection : connections ) {
+    if( !connection->reconnect( Qt::ConnectionType( Qt::AutoConnection | Qt::UniqueConnection ) ) ) {
+      ++failed;
+    }
+  }
+
+  return failed;
+}
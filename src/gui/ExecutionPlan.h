@@ -0,0 +1,58 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <vector>
+
+class QGraphicsScene;
+class QThread;
+class QNEBlock;
+class QNEConnection;
+
+// the blocks and connections of the node editor, sorted topologically, so the data flows from the start of the
+// plan to its end. The plan doesn't run the blocks itself, the signals still do: orderConnections() only connects
+// every signal and slot again, ordered by the receivers in the plan. Qt calls the slots of a signal in the order
+// they were connected, so the receivers of one output are called in the order of the data flow.
+// The blocks without GUI or 3D parts can be moved to a control thread, so a busy GUI thread doesn't delay
+// them. The connections to and from the GUI thread are then queued
+class ExecutionPlan {
+  public:
+    void build( QGraphicsScene* scene );
+
+    // moves all the blocks that allow it to the given thread
+    // returns the number of blocks moved
+    int moveToControlThread( QThread* thread );
+
+    // returns the number of connections that couldn't be connected again
+    int orderConnections();
+
+    const std::vector<QNEBlock*>& blocks() const {
+      return orderedBlocks;
+    }
+
+    // connections closing a loop in the graph; they are still connected, but can't be ordered
+    const std::vector<QNEConnection*>& feedbackConnections() const {
+      return loopConnections;
+    }
+
+  private:
+    std::vector<QNEBlock*> orderedBlocks;
+    std::vector<QNEConnection*> orderedConnections;
+    std::vector<QNEConnection*> loopConnections;
+};
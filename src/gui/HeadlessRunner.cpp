@@ -0,0 +1,241 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#include "HeadlessRunner.h"
+
+#include <QCoreApplication>
+#include <QGraphicsScene>
+#include <QFile>
+#include <QJsonDocument>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QThread>
+#include <QDebug>
+
+#include "../qnodeseditor/qneblock.h"
+
+#include "ConfigLoader.h"
+#include "ExecutionPlan.h"
+#include "VectorBlockModel.h"
+#include "NumberBlockModel.h"
+#include "StringBlockModel.h"
+
+#include "../block/VectorObject.h"
+#include "../block/NumberObject.h"
+#include "../block/StringObject.h"
+
+#include "../block/AckermannSteering.h"
+#include "../block/PoseSimulation.h"
+#include "../block/PoseSynchroniser.h"
+
+#ifdef SERIALPORT_ENABLED
+#include "../block/SerialPort.h"
+#endif
+
+#include "../block/UbxParser.h"
+#include "../block/NmeaParserGGA.h"
+#include "../block/NmeaParserHDT.h"
+#include "../block/NmeaParserRMC.h"
+#include "../block/TransverseMercatorConverter.h"
+
+#include "../block/GlobalPlannerLines.h"
+#include "../block/GuidanceLocalPlanner.h"
+#include "../block/GuidanceStanley.h"
+#include "../block/GuidanceXte.h"
+
+#include "../block/DebugSink.h"
+#include "../block/PrintLatency.h"
+
+#include "../block/UdpSocket.h"
+#include "../block/FileStream.h"
+#include "../block/RawStreamRecorder.h"
+#include "../block/CommunicationPgn7FFE.h"
+#include "../block/CommunicationJrk.h"
+
+#include "../block/ValueTransmissionNumber.h"
+#include "../block/ValueTransmissionQuaternion.h"
+#include "../block/ValueTransmissionBase64Data.h"
+#include "../block/ValueTransmissionDemux.h"
+#include "../block/ValueTransmissionState.h"
+
+#include "../kinematic/GeographicConvertionWrapper.h"
+#include "../kinematic/FixedKinematic.h"
+#include "../kinematic/TrailerKinematic.h"
+
+#include "../helpers/SimulationClock.h"
+
+HeadlessRunner::HeadlessRunner() {
+  // initialise the wrapper for the geographic conversion, so all offsets are the same application-wide
+  geographicConvertionWrapperGuidance = new GeographicConvertionWrapper();
+  geographicConvertionWrapperSimulator = new GeographicConvertionWrapper();
+
+  scene = new QGraphicsScene();
+
+  vectorBlockModel = new VectorBlockModel( scene );
+  numberBlockModel = new NumberBlockModel( scene );
+  stringBlockModel = new StringBlockModel( scene );
+
+  // simulator; a system block, so it is found by its name when loading
+  auto* poseSimulationFactory = new PoseSimulationFactory( geographicConvertionWrapperSimulator );
+  factories.push_back( poseSimulationFactory );
+  auto* poseSimulationBlock = poseSimulationFactory->createBlock( scene );
+  poseSimulation = qobject_cast<PoseSimulation*>( poseSimulationBlock->object );
+
+  // global planner; also a system block, it makes the plan without showing it
+  auto* globalPlannerFactory = new GlobalPlannerFactory( nullptr, nullptr, geographicConvertionWrapperGuidance );
+  factories.push_back( globalPlannerFactory );
+  globalPlannerFactory->createBlock( scene );
+
+  // the factories of all the blocks without a 3D model or a widget
+  factories.push_back( new VectorFactory( vectorBlockModel ) );
+  factories.push_back( new NumberFactory( numberBlockModel ) );
+  factories.push_back( new StringFactory( stringBlockModel ) );
+  factories.push_back( new FixedKinematicFactory() );
+  factories.push_back( new TrailerKinematicFactory() );
+  factories.push_back( new AckermannSteeringFactory() );
+  factories.push_back( new PoseSynchroniserFactory() );
+  factories.push_back( new TransverseMercatorConverterFactory( geographicConvertionWrapperGuidance ) );
+  factories.push_back( new XteGuidanceFactory() );
+  factories.push_back( new StanleyGuidanceFactory() );
+  factories.push_back( new LocalPlannerFactory() );
+  factories.push_back( new UbxParserFactory() );
+  factories.push_back( new NmeaParserGGAFactory() );
+  factories.push_back( new NmeaParserHDTFactory() );
+  factories.push_back( new NmeaParserRMCFactory() );
+  factories.push_back( new DebugSinkFactory() );
+  factories.push_back( new PrintLatencyFactory() );
+  factories.push_back( new ValueTransmissionNumberFactory() );
+  factories.push_back( new ValueTransmissionQuaternionFactory() );
+  factories.push_back( new ValueTransmissionStateFactory() );
+  factories.push_back( new ValueTransmissionBase64DataFactory() );
+  factories.push_back( new ValueTransmissionDemuxFactory() );
+  factories.push_back( new UdpSocketFactory() );
+#ifdef SERIALPORT_ENABLED
+  factories.push_back( new SerialPortFactory() );
+#endif
+  factories.push_back( new FileStreamFactory() );
+  factories.push_back( new RawStreamRecorderFactory() );
+  factories.push_back( new CommunicationPgn7ffeFactory() );
+  factories.push_back( new CommunicationJrkFactory() );
+}
+
+HeadlessRunner::~HeadlessRunner() {
+  // the blocks delete their objects with deleteLater(), so process them before the factories and wrappers go away
+  delete scene;
+  QCoreApplication::sendPostedEvents( nullptr, QEvent::DeferredDelete );
+
+  if( controlThread != nullptr ) {
+    controlThread->quit();
+    controlThread->wait();
+    delete controlThread;
+  }
+
+  for( auto* factory : factories ) {
+    delete factory;
+  }
+
+  delete geographicConvertionWrapperGuidance;
+  delete geographicConvertionWrapperSimulator;
+}
+
+BlockFactory* HeadlessRunner::factoryForType( const QString& type ) const {
+  for( auto* factory : factories ) {
+    if( factory->getNameOfFactory() == type ) {
+      return factory;
+    }
+  }
+
+  return nullptr;
+}
+
+bool HeadlessRunner::loadConfig( const QString& fileName ) {
+  QFile file( fileName );
+
+  if( !file.open( QIODevice::ReadOnly ) ) {
+    qWarning() << "Couldn't open config file" << fileName;
+    return false;
+  }
+
+  QJsonParseError error;
+  QJsonDocument loadDoc( QJsonDocument::fromJson( file.readAll(), &error ) );
+
+  if( loadDoc.isNull() ) {
+    qWarning() << "Couldn't parse config file" << fileName << error.errorString();
+    return false;
+  }
+
+  ConfigLoader loader( scene, [this]( const QString & type ) {
+    return factoryForType( type );
+  } );
+  loader.selectLoadedItems = false;
+  const int skipped = loader.load( loadDoc.object() );
+
+  if( skipped != 0 ) {
+    qWarning() << "Headless:" << skipped << "blocks skipped, as they need the GUI";
+  }
+
+  // the same global settings as the GUI uses
+  QSettings settings( QStandardPaths::writableLocation( QStandardPaths::AppDataLocation ) + "/config.ini",
+                      QSettings::IniFormat );
+
+  const bool orderConnections = settings.value( QStringLiteral( "OrderConnections" ), false ).toBool();
+  bool useControlThread = settings.value( QStringLiteral( "ControlThread" ), false ).toBool();
+
+  // the virtual time is only deterministic, if all the blocks run in the thread of the clock
+  if( useControlThread && SimulationClock::instance().mode() == SimulationClock::Mode::Virtual ) {
+    qWarning() << "Headless: no control thread in virtual time";
+    useControlThread = false;
+  }
+
+  if( orderConnections || useControlThread ) {
+    ExecutionPlan plan;
+    plan.build( scene );
+
+    if( useControlThread ) {
+      controlThread = new QThread();
+      controlThread->setObjectName( QStringLiteral( "ControlThread" ) );
+      controlThread->start( QThread::TimeCriticalPriority );
+
+      qDebug() << "Control thread:" << plan.moveToControlThread( controlThread ) << "blocks moved";
+    }
+
+    if( orderConnections ) {
+      const int failed = plan.orderConnections();
+
+      qDebug() << "Execution plan:" << plan.blocks().size() << "blocks," << plan.feedbackConnections().size() << "loops," << failed << "connections not ordered";
+    }
+  }
+
+  // as new values for the blocks are added above, emit all signals now, when the connections are made
+  const auto& constRefOfList = scene->items();
+
+  for( const auto& item : constRefOfList ) {
+    auto* block = qgraphicsitem_cast<QNEBlock*>( item );
+
+    if( block != nullptr ) {
+      block->emitConfigSignals();
+    }
+  }
+
+  if( settings.value( QStringLiteral( "RunSimulatorOnStart" ), false ).toBool() ) {
+    // queued, if the simulation runs on the control thread
+    QMetaObject::invokeMethod( poseSimulation, "setSimulation", Q_ARG( bool, true ) );
+  }
+
+  return true;
+}
@@ -0,0 +1,61 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <QString>
+
+#include <vector>
+
+class QGraphicsScene;
+class QThread;
+class BlockFactory;
+class GeographicConvertionWrapper;
+class PoseSimulation;
+class VectorBlockModel;
+class NumberBlockModel;
+class StringBlockModel;
+
+// runs a saved config without the 3D view, the docks and the settings dialog (--headless --config file.json).
+// Only the blocks without rendering parts have a factory, so the 3D models, docks and the planner GUI
+// of a config are skipped. The scene holding the graph is never shown
+class HeadlessRunner {
+  public:
+    HeadlessRunner();
+    ~HeadlessRunner();
+
+    bool loadConfig( const QString& fileName );
+
+  private:
+    BlockFactory* factoryForType( const QString& type ) const;
+
+  private:
+    QGraphicsScene* scene = nullptr;
+    QThread* controlThread = nullptr;
+
+    GeographicConvertionWrapper* geographicConvertionWrapperGuidance = nullptr;
+    GeographicConvertionWrapper* geographicConvertionWrapperSimulator = nullptr;
+
+    VectorBlockModel* vectorBlockModel = nullptr;
+    NumberBlockModel* numberBlockModel = nullptr;
+    StringBlockModel* stringBlockModel = nullptr;
+
+    std::vector<BlockFactory*> factories;
+
+    PoseSimulation* poseSimulation = nullptr;
+};
@@ -117,7 +117,7 @@ bool NumberBlockModel::setData( const QModelIndex& index, const QVariant& value,
 
             case 1:
               object->number = value.toString().toFloat();
-              object->emitConfigSignals();
+              block->emitConfigSignals();
               emit dataChanged( index, index, QVector<int>() << role );
               return true;
           }
@@ -80,12 +80,14 @@
 
 #include "../block/UdpSocket.h"
 #include "../block/FileStream.h"
+#include "../block/RawStreamRecorder.h"
 #include "../block/CommunicationPgn7FFE.h"
 #include "../block/CommunicationJrk.h"
 
 #include "../block/ValueTransmissionNumber.h"
 #include "../block/ValueTransmissionQuaternion.h"
 #include "../block/ValueTransmissionBase64Data.h"
+#include "../block/ValueTransmissionDemux.h"
 #include "../block/ValueTransmissionState.h"
 
 #include "../kinematic/GeographicConvertionWrapper.h"
@@ -94,6 +96,12 @@
 
 #include "../cgalKernel.h"
 
+#include "../helpers/SimulationClock.h"
+
+#include "ExecutionPlan.h"
+#include "BlockProfiler.h"
+#include "ConfigLoader.h"
+
 SettingsDialog::SettingsDialog( Qt3DCore::QEntity* rootEntity, QMainWindow* mainWindow, QWidget* parent ) :
   QDialog( parent ),
   mainWindow( mainWindow ),
@@ -119,6 +127,8 @@ SettingsDialog::SettingsDialog( Qt3DCore::QEntity* rootEntity, QMainWindow* main
       ui->cbRunSimulatorOnStart->setCheckState( settings.value( QStringLiteral( "RunSimulatorOnStart" ), false ).toBool() ? Qt::CheckState::Checked : Qt::CheckState::Unchecked );
       ui->cbRestoreDockPositions->setCheckState( settings.value( QStringLiteral( "RestoreDockPositionsOnStart" ), false ).toBool() ? Qt::CheckState::Checked : Qt::CheckState::Unchecked );
       ui->cbSaveDockPositionsOnExit->setCheckState( settings.value( QStringLiteral( "SaveDockPositionsOnExit" ), false ).toBool() ? Qt::CheckState::Checked : Qt::CheckState::Unchecked );
+      ui->cbOrderConnections->setCheckState( settings.value( QStringLiteral( "OrderConnections" ), false ).toBool() ? Qt::CheckState::Checked : Qt::CheckState::Unchecked );
+      ui->cbControlThread->setCheckState( settings.value( QStringLiteral( "ControlThread" ), false ).toBool() ? Qt::CheckState::Checked : Qt::CheckState::Unchecked );
     }
 
     // grid
@@ -285,6 +295,7 @@ SettingsDialog::SettingsDialog( Qt3DCore::QEntity* rootEntity, QMainWindow* main
 #endif
 
   fileStreamFactory = new FileStreamFactory();
+  rawStreamRecorderFactory = new RawStreamRecorderFactory();
   communicationPgn7ffeFactory = new CommunicationPgn7ffeFactory();
   communicationJrkFactory = new CommunicationJrkFactory();
   ubxParserFactory = new UbxParserFactory();
@@ -297,6 +308,7 @@ SettingsDialog::SettingsDialog( Qt3DCore::QEntity* rootEntity, QMainWindow* main
   valueTransmissionQuaternionFactory = new ValueTransmissionQuaternionFactory();
   valueTransmissionStateFactory = new ValueTransmissionStateFactory();
   valueTransmissionBase64DataFactory = new ValueTransmissionBase64DataFactory();
+  valueTransmissionDemuxFactory = new ValueTransmissionDemuxFactory();
 
   vectorFactory->addToCombobox( ui->cbNodeType );
   numberFactory->addToCombobox( ui->cbNodeType );
@@ -322,6 +334,7 @@ SettingsDialog::SettingsDialog( Qt3DCore::QEntity* rootEntity, QMainWindow* main
   valueTransmissionQuaternionFactory->addToCombobox( ui->cbNodeType );
   valueTransmissionStateFactory->addToCombobox( ui->cbNodeType );
   valueTransmissionBase64DataFactory->addToCombobox( ui->cbNodeType );
+  valueTransmissionDemuxFactory->addToCombobox( ui->cbNodeType );
 
   udpSocketFactory->addToCombobox( ui->cbNodeType );
 
@@ -330,6 +343,7 @@ SettingsDialog::SettingsDialog( Qt3DCore::QEntity* rootEntity, QMainWindow* main
 #endif
 
   fileStreamFactory->addToCombobox( ui->cbNodeType );
+  rawStreamRecorderFactory->addToCombobox( ui->cbNodeType );
   communicationPgn7ffeFactory->addToCombobox( ui->cbNodeType );
   communicationJrkFactory->addToCombobox( ui->cbNodeType );
   printLatencyFactory->addToCombobox( ui->cbNodeType );
@@ -349,8 +363,22 @@ SettingsDialog::SettingsDialog( Qt3DCore::QEntity* rootEntity, QMainWindow* main
 }
 
 SettingsDialog::~SettingsDialog() {
+  BlockProfiler::instance().stop();
+
+  // the blocks delete their objects with deleteLater(), so delete them and process the deletions before the
+  // control thread is stopped: a finishing thread still deletes the objects posted to it, a finished one never does.
+  // The system blocks and the models of the tables go with the scene
+  delete ui->gvNodeEditor->scene();
+  QCoreApplication::sendPostedEvents( nullptr, QEvent::DeferredDelete );
+
   delete ui;
 
+  if( controlThread != nullptr ) {
+    controlThread->quit();
+    controlThread->wait();
+    delete controlThread;
+  }
+
   transverseMercatorConverterFactory->deleteLater();
   poseSynchroniserFactory->deleteLater();
   tractorModelFactory->deleteLater();
@@ -369,12 +397,14 @@ SettingsDialog::~SettingsDialog() {
   valueTransmissionQuaternionFactory->deleteLater();
   valueTransmissionStateFactory->deleteLater();
   valueTransmissionBase64DataFactory->deleteLater();
+  valueTransmissionDemuxFactory->deleteLater();
 
 #ifdef SERIALPORT_ENABLED
   serialPortFactory->deleteLater();
 #endif
 
   fileStreamFactory->deleteLater();
+  rawStreamRecorderFactory->deleteLater();
   communicationPgn7ffeFactory->deleteLater();
   communicationJrkFactory->deleteLater();
   nmeaParserGGAFactory->deleteLater();
@@ -382,15 +412,9 @@ SettingsDialog::~SettingsDialog() {
   nmeaParserRMCFactory->deleteLater();
   ackermannSteeringFactory->deleteLater();
 
-  vectorBlockModel->deleteLater();
-  numberBlockModel->deleteLater();
-  stringBlockModel->deleteLater();
-
-  implementBlockModel->deleteLater();
   implementSectionModel->deleteLater();
 
   poseSimulationFactory->deleteLater();
-  poseSimulation->deleteLater();
 
 #ifdef SPNAV_ENABLED
   spaceNavigatorPollingThread->stop();
@@ -403,17 +427,11 @@ SettingsDialog::~SettingsDialog() {
 #endif
 
   plannerGuiFactory->deleteLater();
-  plannerGui->deleteLater();
   globalPlannerFactory->deleteLater();
-  globalPlanner->deleteLater();
   localPlannerFactory->deleteLater();
-  localPlanner->deleteLater();
   stanleyGuidanceFactory->deleteLater();
-  stanleyGuidance->deleteLater();
   xteGuidanceFactory->deleteLater();
-  xteGuidance->deleteLater();
   globalPlannerModelFactory->deleteLater();
-  globalPlannerModel->deleteLater();
 }
 
 QGraphicsScene* SettingsDialog::getSceneOfConfigGraphicsView() {
@@ -572,35 +590,11 @@ void SettingsDialog::saveConfigToFile( QFile& file ) {
 }
 
 QNEBlock* SettingsDialog::getBlockWithId( int id ) {
-  const auto& constRefOfList = ui->gvNodeEditor->scene()->items();
-
-  for( const auto& item : constRefOfList ) {
-    auto* block = qgraphicsitem_cast<QNEBlock*>( item );
-
-    if( block != nullptr ) {
-      if( block->id == id ) {
-        return block;
-      }
-    }
-  }
-
-  return nullptr;
+  return QNEBlock::getBlockWithId( ui->gvNodeEditor->scene(), id );
 }
 
 QNEBlock* SettingsDialog::getBlockWithName( const QString& name ) {
-  const auto& constRefOfList = ui->gvNodeEditor->scene()->items();
-
-  for( const auto& item : constRefOfList ) {
-    auto* block = qgraphicsitem_cast<QNEBlock*>( item );
-
-    if( block != nullptr ) {
-      if( block->getName() == name ) {
-        return block;
-      }
-    }
-  }
-
-  return nullptr;
+  return QNEBlock::getBlockWithName( ui->gvNodeEditor->scene(), name );
 }
 
 void SettingsDialog::on_pbLoad_clicked() {
@@ -675,93 +669,33 @@ void SettingsDialog::loadConfigFromFile( QFile& file ) {
   QJsonDocument loadDoc( QJsonDocument::fromJson( saveData ) );
   QJsonObject json = loadDoc.object();
 
-  // as the new object get new id, here is a QMap to hold the conversions
-  // first int: id in file, second int: id in the graphicsview
-  QMap<int, int> idMap;
-
-  if( json.contains( QStringLiteral( "blocks" ) ) && json[QStringLiteral( "blocks" )].isArray() ) {
-    QJsonArray blocksArray = json[QStringLiteral( "blocks" )].toArray();
-
-    for( const auto& blockIndex : qAsConst( blocksArray ) ) {
-      QJsonObject blockObject = blockIndex.toObject();
-      int id = blockObject[QStringLiteral( "id" )].toInt( 0 );
-
-      // if id is a system-id -> search the block and set the values
-      if( id != 0 ) {
-
-        // system id -> don't create new blocks
-        if( id < int( QNEBlock::IdRange::UserIdStart ) ) {
-          QNEBlock* block = getBlockWithName( blockObject[QStringLiteral( "type" )].toString() );
-
-          if( block != nullptr ) {
-            idMap.insert( id, block->id );
-            block->setX( blockObject[QStringLiteral( "positionX" )].toDouble( 0 ) );
-            block->setY( blockObject[QStringLiteral( "positionY" )].toDouble( 0 ) );
-          }
-
-          // id is not a system-id -> create new blocks
-        } else {
-          int index = ui->cbNodeType->findText( blockObject[QStringLiteral( "type" )].toString(), Qt::MatchExactly );
-          auto* factory = qobject_cast<BlockFactory*>( qvariant_cast<QObject*>( ui->cbNodeType->itemData( index ) ) );
-
-          if( factory != nullptr ) {
-            QNEBlock* block = factory->createBlock( ui->gvNodeEditor->scene(), id );
-
-            idMap.insert( id, block->id );
-
-            block->setX( blockObject[QStringLiteral( "positionX" )].toDouble( 0 ) );
-            block->setY( blockObject[QStringLiteral( "positionY" )].toDouble( 0 ) );
-            block->setName( blockObject[QStringLiteral( "name" )].toString( factory->getNameOfFactory() ) );
-            block->fromJSON( blockObject );
-            block->setSelected( true );
-          }
-        }
+  ConfigLoader loader( ui->gvNodeEditor->scene(), [this]( const QString & type ) {
+    int index = ui->cbNodeType->findText( type, Qt::MatchExactly );
+    return qobject_cast<BlockFactory*>( qvariant_cast<QObject*>( ui->cbNodeType->itemData( index ) ) );
+  } );
+  loader.load( json );
+
+  if( ui->cbOrderConnections->isChecked() || ui->cbControlThread->isChecked() ) {
+    ExecutionPlan plan;
+    plan.build( ui->gvNodeEditor->scene() );
+
+    // the virtual time is only deterministic, if all the blocks run in the thread of the clock
+    if( ui->cbControlThread->isChecked() && SimulationClock::instance().mode() == SimulationClock::Mode::Virtual ) {
+      qWarning() << "No control thread in virtual time";
+    } else if( ui->cbControlThread->isChecked() ) {
+      if( controlThread == nullptr ) {
+        controlThread = new QThread();
+        controlThread->setObjectName( QStringLiteral( "ControlThread" ) );
+        controlThread->start( QThread::TimeCriticalPriority );
       }
-    }
-  }
-
-
-  if( json.contains( QStringLiteral( "connections" ) ) && json[QStringLiteral( "connections" )].isArray() ) {
-    QJsonArray connectionsArray = json[QStringLiteral( "connections" )].toArray();
-
-    for( const auto& connectionsIndex : qAsConst( connectionsArray ) ) {
-      QJsonObject connectionsObject = connectionsIndex.toObject();
-
-      if( !connectionsObject[QStringLiteral( "idFrom" )].isUndefined() &&
-          !connectionsObject[QStringLiteral( "idTo" )].isUndefined() &&
-          !connectionsObject[QStringLiteral( "portFrom" )].isUndefined() &&
-          !connectionsObject[QStringLiteral( "portTo" )].isUndefined() ) {
 
-        int idFrom = idMap[connectionsObject[QStringLiteral( "idFrom" )].toInt()];
-        int idTo = idMap[connectionsObject[QStringLiteral( "idTo" )].toInt()];
-
-        if( idFrom != 0 && idTo != 0 ) {
-          QNEBlock* blockFrom = getBlockWithId( idFrom );
-          QNEBlock* blockTo = getBlockWithId( idTo );
-
-          if( ( blockFrom != nullptr ) && ( blockTo != nullptr ) ) {
-            QString portFromName = connectionsObject[QStringLiteral( "portFrom" )].toString();
-            QString portToName = connectionsObject[QStringLiteral( "portTo" )].toString();
-
-            QNEPort* portFrom = blockFrom->getPortWithName( portFromName, true );
-            QNEPort* portTo = blockTo->getPortWithName( portToName, false );
+      qDebug() << "Control thread:" << plan.moveToControlThread( controlThread ) << "blocks moved";
+    }
 
-            if( ( portFrom != nullptr ) && ( portTo != nullptr ) ) {
-              auto* conn = new QNEConnection();
-              conn->setPort1( portFrom );
+    if( ui->cbOrderConnections->isChecked() ) {
+      const int failed = plan.orderConnections();
 
-              if( conn->setPort2( portTo ) ) {
-                blockFrom->scene()->addItem( conn );
-                conn->updatePosFromPorts();
-                conn->updatePath();
-                conn->setSelected( true );
-              } else {
-                delete conn;
-              }
-            }
-          }
-        }
-      }
+      qDebug() << "Execution plan:" << plan.blocks().size() << "blocks," << plan.feedbackConnections().size() << "loops," << failed << "connections not ordered";
     }
   }
 
@@ -1469,6 +1403,75 @@ void SettingsDialog::on_cbSaveDockPositionsOnExit_toggled( bool checked ) {
   settings.sync();
 }
 
+void SettingsDialog::on_cbOrderConnections_toggled( bool checked ) {
+  QSettings settings( QStandardPaths::writableLocation( QStandardPaths::AppDataLocation ) + "/config.ini",
+                      QSettings::IniFormat );
+
+  settings.setValue( QStringLiteral( "OrderConnections" ), checked );
+  settings.sync();
+}
+
+void SettingsDialog::on_cbControlThread_toggled( bool checked ) {
+  QSettings settings( QStandardPaths::writableLocation( QStandardPaths::AppDataLocation ) + "/config.ini",
+                      QSettings::IniFormat );
+
+  settings.setValue( QStringLiteral( "ControlThread" ), checked );
+  settings.sync();
+}
+
+void SettingsDialog::on_pbProfile_toggled( bool checked ) {
+  auto& profiler = BlockProfiler::instance();
+
+  if( checked ) {
+    profiler.start( ui->gvNodeEditor->scene() );
+    profiler.reset();
+    profilerTimer.start( 1000, this );
+  } else {
+    profilerTimer.stop();
+    profiler.stop();
+    profiler.clearHeat();
+  }
+}
+
+void SettingsDialog::on_pbExportProfile_clicked() {
+  QString selectedFilter = QStringLiteral( "CSV Files (*.csv)" );
+  QString dir;
+  QString fileName = QFileDialog::getSaveFileName( this,
+                     tr( "Export Profile" ),
+                     dir,
+                     tr( "CSV Files (*.csv);;JSON Files (*.json)" ),
+                     &selectedFilter );
+
+  if( !fileName.isEmpty() ) {
+    QFile exportFile( fileName );
+
+    if( !exportFile.open( QIODevice::WriteOnly ) ) {
+      qWarning() << "Couldn't open export file.";
+      return;
+    }
+
+    if( fileName.endsWith( QStringLiteral( ".json" ), Qt::CaseInsensitive ) ) {
+      exportFile.write( BlockProfiler::instance().toJson().toJson() );
+    } else {
+      exportFile.write( BlockProfiler::instance().toCsv().toUtf8() );
+    }
+  }
+}
+
+void SettingsDialog::timerEvent( QTimerEvent* event ) {
+  if( event->timerId() == profilerTimer.timerId() ) {
+    auto& profiler = BlockProfiler::instance();
+
+    // blocks were added or deleted: profile the new set of blocks from the start
+    if( !profiler.updateHeat() ) {
+      profiler.start( ui->gvNodeEditor->scene() );
+      profiler.updateHeat();
+    }
+  } else {
+    QDialog::timerEvent( event );
+  }
+}
+
 void SettingsDialog::on_pbSaveDockPositions_clicked() {
   QSettings settings( QStandardPaths::writableLocation( QStandardPaths::AppDataLocation ) + "/config.ini",
                       QSettings::IniFormat );
@@ -1497,9 +1500,9 @@ void SettingsDialog::on_pbMeterDefaults_clicked() {
 }
 
 void SettingsDialog::on_rbCrsSimulatorTransverseMercator_toggled( bool checked ) {
-  geographicConvertionWrapperSimulator->useTM = checked;
+  geographicConvertionWrapperSimulator->setUseTM( checked );
 }
 
 void SettingsDialog::on_rbCrsGuidanceTransverseMercator_toggled( bool checked ) {
-  geographicConvertionWrapperGuidance->useTM = checked;
+  geographicConvertionWrapperGuidance->setUseTM( checked );
 }
@@ -21,6 +21,8 @@
 #include <QObject>
 
 #include <QDialog>
+#include <QThread>
+#include <QBasicTimer>
 #include <QVector3D>
 #include <Qt3DCore/QEntity>
 
@@ -164,6 +166,10 @@ class SettingsDialog : public QDialog {
 
     void on_cbRestoreDockPositions_toggled( bool checked );
     void on_cbSaveDockPositionsOnExit_toggled( bool checked );
+    void on_cbOrderConnections_toggled( bool checked );
+    void on_cbControlThread_toggled( bool checked );
+    void on_pbProfile_toggled( bool checked );
+    void on_pbExportProfile_clicked();
     void on_pbSaveDockPositions_clicked();
 
     void on_pbMeterDefaults_clicked();
@@ -171,6 +177,9 @@ class SettingsDialog : public QDialog {
     void on_rbCrsSimulatorTransverseMercator_toggled( bool checked );
     void on_rbCrsGuidanceTransverseMercator_toggled( bool checked );
 
+  protected:
+    void timerEvent( QTimerEvent* event ) override;
+
   private:
     void saveGridValuesInSettings();
     void savePlannerValuesInSettings();
@@ -229,7 +238,14 @@ class SettingsDialog : public QDialog {
     BlockFactory* serialPortFactory = nullptr;
 #endif
 
+    // the blocks moved to it are deleted with deleteLater(), so it runs until the dialog is destroyed
+    QThread* controlThread = nullptr;
+
+    // refreshes the heat of the blocks while profiling
+    QBasicTimer profilerTimer;
+
     BlockFactory* fileStreamFactory = nullptr;
+    BlockFactory* rawStreamRecorderFactory = nullptr;
     BlockFactory* ackermannSteeringFactory = nullptr;
     BlockFactory* ubxParserFactory = nullptr;
     BlockFactory* nmeaParserGGAFactory = nullptr;
@@ -247,6 +263,7 @@ class SettingsDialog : public QDialog {
     BlockFactory* globalPlannerModelFactory = nullptr;
 
     BlockFactory* valueTransmissionBase64DataFactory = nullptr;
+    BlockFactory* valueTransmissionDemuxFactory = nullptr;
     BlockFactory* valueTransmissionNumberFactory = nullptr;
     BlockFactory* valueTransmissionQuaternionFactory = nullptr;
     BlockFactory* valueTransmissionStateFactory = nullptr;
@@ -117,7 +117,7 @@ bool StringBlockModel::setData( const QModelIndex& index, const QVariant& value,
 
             case 1:
               object->string = value.toString();
-              object->emitConfigSignals();
+              block->emitConfigSignals();
               emit dataChanged( index, index, QVector<int>() << role );
               return true;
           }
@@ -126,19 +126,19 @@ bool VectorBlockModel::setData( const QModelIndex& index, const QVariant& value,
 
             case 1:
               object->vector.setX( value.toString().toFloat() );
-              object->emitConfigSignals();
+              block->emitConfigSignals();
               emit dataChanged( index, index, QVector<int>() << role );
               return true;
 
             case 2:
               object->vector.setY( value.toString().toFloat() );
-              object->emitConfigSignals();
+              block->emitConfigSignals();
               emit dataChanged( index, index, QVector<int>() << role );
               return true;
 
             case 3:
               object->vector.setZ( value.toString().toFloat() );
-              object->emitConfigSignals();
+              block->emitConfigSignals();
               emit dataChanged( index, index, QVector<int>() << role );
               return true;
           }
@@ -0,0 +1,104 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <QByteArray>
+#include <QtEndian>
+
+#include <cstring>
+
+// appends CBOR (RFC 7049) items to a QByteArray
+// this is a lot cheaper than building a QCborValue and calling toCbor(), especially when a pre-encoded
+// header is reused and only the payload has to be appended
+namespace CborEncoder {
+  enum MajorType : quint8 {
+    UnsignedInteger = 0,
+    NegativeInteger = 1,
+    ByteString = 2,
+    TextString = 3,
+    Array = 4,
+    Map = 5,
+    Tag = 6,
+    SimpleOrFloat = 7
+  };
+
+  inline void appendHeader( QByteArray& data, const MajorType majorType, const quint64 value ) {
+    const char type = char( majorType << 5 );
+
+    if( value < 24 ) {
+      data.append( char( type | char( value ) ) );
+    } else if( value <= 0xff ) {
+      data.append( char( type | 24 ) );
+      data.append( char( value ) );
+    } else if( value <= 0xffff ) {
+      const quint16 bigEndian = qToBigEndian( quint16( value ) );
+      data.append( char( type | 25 ) );
+      data.append( reinterpret_cast<const char*>( &bigEndian ), sizeof( bigEndian ) );
+    } else if( value <= 0xffffffff ) {
+      const quint32 bigEndian = qToBigEndian( quint32( value ) );
+      data.append( char( type | 26 ) );
+      data.append( reinterpret_cast<const char*>( &bigEndian ), sizeof( bigEndian ) );
+    } else {
+      const quint64 bigEndian = qToBigEndian( value );
+      data.append( char( type | 27 ) );
+      data.append( reinterpret_cast<const char*>( &bigEndian ), sizeof( bigEndian ) );
+    }
+  }
+
+  inline void appendInteger( QByteArray& data, const qint64 value ) {
+    if( value >= 0 ) {
+      appendHeader( data, UnsignedInteger, quint64( value ) );
+    } else {
+      appendHeader( data, NegativeInteger, quint64( -1 - value ) );
+    }
+  }
+
+  inline void appendBool( QByteArray& data, const bool value ) {
+    data.append( value ? char( 0xf5 ) : char( 0xf4 ) );
+  }
+
+  inline void appendFloat( QByteArray& data, const float value ) {
+    quint32 bits;
+    std::memcpy( &bits, &value, sizeof( bits ) );
+    bits = qToBigEndian( bits );
+    data.append( char( 0xfa ) );
+    data.append( reinterpret_cast<const char*>( &bits ), sizeof( bits ) );
+  }
+
+  inline void appendDouble( QByteArray& data, const double value ) {
+    quint64 bits;
+    std::memcpy( &bits, &value, sizeof( bits ) );
+    bits = qToBigEndian( bits );
+    data.append( char( 0xfb ) );
+    data.append( reinterpret_cast<const char*>( &bits ), sizeof( bits ) );
+  }
+
+  inline void appendByteString( QByteArray& data, const QByteArray& value ) {
+    appendHeader( data, ByteString, quint64( value.size() ) );
+    data.append( value );
+  }
+
+  inline void appendArrayHeader( QByteArray& data, const quint64 numItems ) {
+    appendHeader( data, Array, numItems );
+  }
+
+  inline void appendMapHeader( QByteArray& data, const quint64 numPairs ) {
+    appendHeader( data, Map, numPairs );
+  }
+}
@@ -0,0 +1,215 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <QtGlobal>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <vector>
+
+#include "IoDeviceThread.h"
+
+#if defined(Q_OS_LINUX)
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <netinet/in.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+// receives many datagrams with one syscall (recvmmsg) into a pool of buffers, which is allocated once
+// every datagram gets the receive timestamp of the kernel (SO_TIMESTAMPNS), so the measured latency starts at
+// the network interface. Only available on linux; isAvailable() returns false on other platforms.
+// The receiver has its own socket: a QUdpSocket only rearms its read notification in readDatagram(), so it
+// can't be read from behind its back. Watch socketDescriptor() with a QSocketNotifier to know when to read
+class DatagramBatchReceiver {
+  public:
+    static constexpr int BatchSize = 32;
+    static constexpr int MaxDatagramSize = 8192;
+
+    static constexpr bool isAvailable() {
+#if defined(Q_OS_LINUX)
+      return true;
+#else
+      return false;
+#endif
+    }
+
+#if defined(Q_OS_LINUX)
+    DatagramBatchReceiver()
+      : buffers( size_t( BatchSize * MaxDatagramSize ) ) {
+      for( size_t i = 0; i < size_t( BatchSize ); ++i ) {
+        iovecs[i].iov_base = buffers.data() + i * MaxDatagramSize;
+        iovecs[i].iov_len = MaxDatagramSize;
+      }
+    }
+
+    ~DatagramBatchReceiver() {
+      close();
+    }
+
+    // opens a socket bound to the port on all the interfaces; returns false on errors
+    bool bind( const quint16 port ) {
+      close();
+
+      socketDescriptor = ::socket( AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0 );
+
+      if( socketDescriptor < 0 ) {
+        return false;
+      }
+
+      int enable = 1;
+      ::setsockopt( socketDescriptor, SOL_SOCKET, SO_TIMESTAMPNS, &enable, sizeof( enable ) );
+
+      sockaddr_in address;
+      std::memset( &address, 0, sizeof( address ) );
+      address.sin_family = AF_INET;
+      address.sin_addr.s_addr = htonl( INADDR_ANY );
+      address.sin_port = htons( port );
+
+      if( ::bind( socketDescriptor, reinterpret_cast<const sockaddr*>( &address ), sizeof( address ) ) != 0 ) {
+        close();
+        return false;
+      }
+
+      return true;
+    }
+
+    void close() {
+      if( socketDescriptor >= 0 ) {
+        ::close( socketDescriptor );
+      }
+
+      socketDescriptor = -1;
+      numReceived = 0;
+      current = 0;
+    }
+
+    int getSocketDescriptor() const {
+      return socketDescriptor;
+    }
+
+    // hands out the next datagram; returns false if there are no more datagrams
+    bool read( IoDeviceThread::Chunk& chunk ) {
+      for( ;; ) {
+        if( current == numReceived && !receiveBatch() ) {
+          return false;
+        }
+
+        const mmsghdr& message = messages[size_t( current )];
+        const auto* begin = static_cast<const char*>( iovecs[size_t( current )].iov_base );
+        ++current;
+
+        // datagrams bigger than the buffers are dropped
+        if( ( message.msg_hdr.msg_flags & MSG_TRUNC ) != 0 ) {
+          ++truncatedDatagrams;
+          continue;
+        }
+
+        chunk.data.resize( int( message.msg_len ) );
+        std::copy( begin, begin + message.msg_len, chunk.data.begin() );
+        chunk.timestamp = kernelTimestamp( message.msg_hdr );
+
+        return true;
+      }
+    }
+
+  private:
+    bool receiveBatch() {
+      current = 0;
+      numReceived = 0;
+
+      if( socketDescriptor < 0 ) {
+        return false;
+      }
+
+      // the kernel overwrites the lengths, so reset them for every call
+      for( size_t i = 0; i < size_t( BatchSize ); ++i ) {
+        messages[i].msg_hdr.msg_name = nullptr;
+        messages[i].msg_hdr.msg_namelen = 0;
+        messages[i].msg_hdr.msg_iov = &iovecs[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+        messages[i].msg_hdr.msg_control = controlBuffers[i].data();
+        messages[i].msg_hdr.msg_controllen = controlBuffers[i].size();
+        messages[i].msg_hdr.msg_flags = 0;
+        messages[i].msg_len = 0;
+      }
+
+      int result = ::recvmmsg( socketDescriptor, messages.data(), BatchSize, MSG_DONTWAIT, nullptr );
+
+      if( result <= 0 ) {
+        return false;
+      }
+
+      numReceived = result;
+      return true;
+    }
+
+    // converts the timestamp of the kernel (realtime clock) to the steady clock used for the latencies
+    static qint64 kernelTimestamp( const msghdr& header ) {
+      for( cmsghdr* cmsg = CMSG_FIRSTHDR( &header ); cmsg != nullptr; cmsg = CMSG_NXTHDR( const_cast<msghdr*>( &header ), cmsg ) ) {
+        if( cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS ) {
+          timespec timestamp;
+          std::memcpy( &timestamp, CMSG_DATA( cmsg ), sizeof( timestamp ) );
+
+          timespec realtimeNow;
+          ::clock_gettime( CLOCK_REALTIME, &realtimeNow );
+
+          const qint64 age = ( qint64( realtimeNow.tv_sec ) - qint64( timestamp.tv_sec ) ) * 1000000000 +
+                             ( qint64( realtimeNow.tv_nsec ) - qint64( timestamp.tv_nsec ) );
+
+          return IoDeviceThread::now() - qMax( age, qint64( 0 ) );
+        }
+      }
+
+      return 0;
+    }
+
+  public:
+    quint64 truncatedDatagrams = 0;
+
+  private:
+    int socketDescriptor = -1;
+    int numReceived = 0;
+    int current = 0;
+
+    std::vector<char> buffers;
+    std::array<iovec, BatchSize> iovecs;
+    std::array<mmsghdr, BatchSize> messages;
+    std::array<std::array<char, CMSG_SPACE( sizeof( timespec ) )>, BatchSize> controlBuffers;
+#else
+    bool bind( const quint16 ) {
+      return false;
+    }
+
+    void close() {}
+
+    int getSocketDescriptor() const {
+      return -1;
+    }
+
+    bool read( IoDeviceThread::Chunk& ) {
+      return false;
+    }
+
+    quint64 truncatedDatagrams = 0;
+#endif
+};
@@ -0,0 +1,224 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <QObject>
+#include <QThread>
+#include <QByteArray>
+#include <QIODevice>
+#include <QElapsedTimer>
+#include <QBasicTimer>
+#include <QTimerEvent>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+
+#include "LatencyHistogram.h"
+#include "SpscRingBuffer.h"
+
+// reads a QIODevice (serial port, UDP socket) into a lock-free ring buffer and hands the received chunks to
+// the thread of the block. If enabled, the device is moved to its own thread, so stalls of the GUI thread
+// don't delay or lose received data.
+// Create it with the block as parent: it takes the ownership of the device and keeps it as a child as long as
+// it isn't threaded, so both follow the block to the control thread.
+// all the public functions have to be called from the thread of the block
+class IoDeviceThread : public QObject {
+    Q_OBJECT
+
+  public:
+    struct Chunk {
+      // time of reception; steady clock, ns
+      qint64 timestamp = 0;
+      QByteArray data;
+    };
+
+    // called on the thread of the device; fills the given chunk with the next chunk of data
+    // the timestamp can be set by the function (to a kernel timestamp for example); if left at 0, the
+    // current time is used. Returns false if there is no more data available
+    using ReadFunction = std::function<bool( Chunk& )>;
+
+    static qint64 now() {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch() ).count();
+    }
+
+  public:
+    IoDeviceThread( QIODevice* device, ReadFunction readFunction, QObject* parent, size_t numChunks = 64 )
+      : QObject( parent ), device( device ), readFunction( std::move( readFunction ) ), ring( numChunks ) {
+      device->setParent( this );
+      connect( device, &QIODevice::readyRead,
+               this, &IoDeviceThread::readFromDevice, Qt::DirectConnection );
+      elapsedSinceStatistics.start();
+      statisticsTimer.start( 1000, this );
+    }
+
+    // the device is deleted as a child
+    ~IoDeviceThread() {
+      setThreaded( false );
+    }
+
+    bool isThreaded() const {
+      return thread != nullptr;
+    }
+
+    void setThreaded( const bool threaded ) {
+      if( threaded && thread == nullptr ) {
+        thread = new QThread();
+        thread->setObjectName( QStringLiteral( "IoDeviceThread" ) );
+        // objects with a parent can't be moved
+        device->setParent( nullptr );
+        device->moveToThread( thread );
+        thread->start( QThread::TimeCriticalPriority );
+      }
+
+      if( !threaded && thread != nullptr ) {
+        // moveToThread() has to be called on the thread the object currently lives in
+        QThread* targetThread = QObject::thread();
+        QMetaObject::invokeMethod( device, [this, targetThread] {
+          device->moveToThread( targetThread );
+        }, Qt::BlockingQueuedConnection );
+
+        thread->quit();
+        thread->wait();
+        delete thread;
+        thread = nullptr;
+
+        device->setParent( this );
+
+        processReceivedChunks();
+      }
+    }
+
+    // runs function on the thread of the device: use it for everything that touches the device
+    template<typename Function>
+    void invoke( Function function ) {
+      if( thread != nullptr ) {
+        QMetaObject::invokeMethod( device, function, Qt::QueuedConnection );
+      } else {
+        function();
+      }
+    }
+
+  signals:
+    // time of reception of the following data; steady clock, s
+    void timestampChanged( const double );
+    void dataReceived( const QByteArray& );
+
+    // statistics of the last second, emitted once a second, also if nothing was received
+    void latencyChanged( const double );
+    void overrunsChanged( const double );
+    void bytesPerSecondChanged( const double );
+
+  public slots:
+    // called on the thread of the device, on readyRead() of the device or by the block, if it gets
+    // notified about new data in another way
+    void readFromDevice() {
+      bool dataAvailable = true;
+
+      while( dataAvailable ) {
+        Chunk* chunk = ring.beginWrite();
+
+        if( chunk != nullptr ) {
+          chunk->timestamp = 0;
+          dataAvailable = readFunction( *chunk );
+
+          if( dataAvailable ) {
+            if( chunk->timestamp == 0 ) {
+              chunk->timestamp = now();
+            }
+
+            ring.commitWrite();
+          }
+        } else {
+          // the buffer is full: read the data anyway, as it would pile up in the device otherwise
+          dataAvailable = readFunction( overrunChunk );
+
+          if( dataAvailable ) {
+            overruns.fetch_add( 1, std::memory_order_relaxed );
+          }
+        }
+      }
+
+      // only queue one call to the thread of the block, even if readyRead() fires multiple times
+      if( !notificationPending.exchange( true ) ) {
+        if( thread != nullptr ) {
+          QMetaObject::invokeMethod( this, &IoDeviceThread::processReceivedChunks, Qt::QueuedConnection );
+        } else {
+          processReceivedChunks();
+        }
+      }
+    }
+
+  private:
+    // called on the thread of the block
+    void processReceivedChunks() {
+      notificationPending.store( false );
+
+      const qint64 timestampOfProcessing = now();
+
+      for( Chunk* chunk = ring.front(); chunk != nullptr; chunk = ring.front() ) {
+        const qint64 timestamp = chunk->timestamp;
+        maxLatency = qMax( maxLatency, timestampOfProcessing - timestamp );
+        bytesReceived += chunk->data.size();
+
+        // copy the data out of the ring into a buffer, that is reused as long as no receiver holds a copy of it
+        receiveBuffer.resize( chunk->data.size() );
+        std::copy( chunk->data.cbegin(), chunk->data.cend(), receiveBuffer.begin() );
+        ring.pop();
+
+        // the age of data at the outputs is measured from the time of reception
+        SampleTimestamp::Scope sampleTimestamp( timestamp );
+        emit timestampChanged( double( timestamp ) / 1e9 );
+        emit dataReceived( receiveBuffer );
+      }
+    }
+
+  protected:
+    void timerEvent( QTimerEvent* event ) override {
+      if( event->timerId() == statisticsTimer.timerId() ) {
+        const double elapsedSeconds = qMax( double( elapsedSinceStatistics.restart() ) / 1000, 0.001 );
+
+        emit latencyChanged( double( maxLatency ) / 1e6 );
+        emit overrunsChanged( double( overruns.exchange( 0, std::memory_order_relaxed ) ) );
+        emit bytesPerSecondChanged( double( bytesReceived ) / elapsedSeconds );
+
+        maxLatency = 0;
+        bytesReceived = 0;
+      }
+    }
+
+  private:
+    QIODevice* device = nullptr;
+    ReadFunction readFunction;
+
+    QThread* thread = nullptr;
+
+    SpscRingBuffer<Chunk> ring;
+    Chunk overrunChunk;
+    std::atomic<bool> notificationPending{false};
+    std::atomic<quint64> overruns{0};
+
+    QByteArray receiveBuffer;
+
+    QBasicTimer statisticsTimer;
+    QElapsedTimer elapsedSinceStatistics;
+    qint64 maxLatency = 0;
+    qint64 bytesReceived = 0;
+};
@@ -0,0 +1,211 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <QObject>
+#include <QBasicTimer>
+#include <QTimerEvent>
+#include <QtAlgorithms>
+
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+// timestamp of the sample that is currently processed; steady clock, ns
+// The ingest blocks open a Scope with the time of reception while they emit the received data, so
+// everything called synchronously from there (parsers, kinematics, guidance, output blocks) sees it.
+// A queued connection (another thread) loses it: the blocks handling a Pose open a Scope with Pose::timestamp()
+class SampleTimestamp {
+  public:
+    class Scope {
+      public:
+        explicit Scope( const qint64 timestamp )
+          : previous( currentOnThisThread() ) {
+          currentOnThisThread() = timestamp;
+        }
+
+        ~Scope() {
+          currentOnThisThread() = previous;
+        }
+
+        Scope( const Scope& ) = delete;
+        Scope& operator=( const Scope& ) = delete;
+
+      private:
+        qint64 previous;
+    };
+
+    static qint64 now() {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     std::chrono::steady_clock::now().time_since_epoch() ).count();
+    }
+
+    // 0 if the sample processed on this thread isn't stamped
+    static qint64 current() {
+      return currentOnThisThread();
+    }
+
+  private:
+    static qint64& currentOnThisThread() {
+      static thread_local qint64 timestamp = 0;
+      return timestamp;
+    }
+};
+
+// HDR-style histogram: the values are sorted into log-linear buckets, SubBuckets per power of two, so each
+// value is kept with a relative error below 1/SubBuckets. Recording is O(1) and doesn't allocate
+class LatencyHistogram {
+  public:
+    static constexpr int SubBucketBits = 6;
+    static constexpr qint64 SubBuckets = qint64( 1 ) << SubBucketBits;
+
+    // bigger values (more than 18 minutes in ns) are clamped
+    static constexpr int MaxValueBits = 40;
+    static constexpr qint64 MaxValue = ( qint64( 1 ) << MaxValueBits ) - 1;
+    static constexpr int NumBuckets = int( ( MaxValueBits - SubBucketBits + 1 ) * SubBuckets );
+
+  public:
+    LatencyHistogram()
+      : counts( NumBuckets, 0 ) {}
+
+    void record( const qint64 value ) {
+      const qint64 clampedValue = qBound( qint64( 0 ), value, MaxValue );
+      ++counts[size_t( indexOf( clampedValue ) )];
+      ++totalCount;
+      maxValue = qMax( maxValue, clampedValue );
+    }
+
+    void reset() {
+      std::fill( counts.begin(), counts.end(), 0 );
+      totalCount = 0;
+      maxValue = 0;
+    }
+
+    quint64 count() const {
+      return totalCount;
+    }
+
+    qint64 max() const {
+      return maxValue;
+    }
+
+    // percentile in [0, 100]; returns the highest value, that is equivalent to the one at the percentile
+    qint64 valueAtPercentile( const double percentile ) const {
+      if( totalCount == 0 ) {
+        return 0;
+      }
+
+      const quint64 countAtPercentile = qMax( quint64( 1 ), quint64( std::ceil( qBound( 0., percentile, 100. ) / 100 * double( totalCount ) ) ) );
+      quint64 cumulativeCount = 0;
+
+      for( size_t i = 0; i < counts.size(); ++i ) {
+        cumulativeCount += counts[i];
+
+        if( cumulativeCount >= countAtPercentile ) {
+          return qMin( highestValueOf( int( i ) ), maxValue );
+        }
+      }
+
+      return maxValue;
+    }
+
+  private:
+    static int indexOf( const qint64 value ) {
+      if( value < SubBuckets ) {
+        return int( value );
+      }
+
+      const int shift = 63 - int( qCountLeadingZeroBits( quint64( value ) ) ) - SubBucketBits;
+      return int( ( shift + 1 ) * SubBuckets + ( ( value >> shift ) - SubBuckets ) );
+    }
+
+    static qint64 highestValueOf( const int index ) {
+      if( index < SubBuckets ) {
+        return index;
+      }
+
+      const int shift = int( index / SubBuckets ) - 1;
+      const qint64 mantissa = index % SubBuckets + SubBuckets;
+      return ( ( mantissa + 1 ) << shift ) - 1;
+    }
+
+  private:
+    std::vector<quint64> counts;
+    quint64 totalCount = 0;
+    qint64 maxValue = 0;
+};
+
+// records the age of the currently processed sample (or another duration) into a histogram and emits the
+// statistics of it once a second in ms. Create it with the block as parent, so it follows the block into other threads
+class LatencyStatistics : public QObject {
+    Q_OBJECT
+
+  public:
+    explicit LatencyStatistics( QObject* parent )
+      : QObject( parent ) {
+      statisticsTimer.start( 1000, this );
+    }
+
+    // call it when the output is sent; nothing is recorded, if the sample isn't stamped
+    void record() {
+      record( SampleTimestamp::current() );
+    }
+
+    void record( const qint64 timestamp ) {
+      if( timestamp != 0 ) {
+        histogram.record( SampleTimestamp::now() - timestamp );
+      }
+    }
+
+    // records a duration in ns, that isn't an age; the jitter of a period for example
+    void recordDuration( const qint64 duration ) {
+      histogram.record( duration );
+    }
+
+    void reset() {
+      histogram.reset();
+    }
+
+  signals:
+    void latencyChanged( const double p50, const double p99, const double max );
+    void p50Changed( const double );
+    void p99Changed( const double );
+    void maxChanged( const double );
+
+  protected:
+    void timerEvent( QTimerEvent* event ) override {
+      if( event->timerId() == statisticsTimer.timerId() && histogram.count() != 0 ) {
+        const double p50 = double( histogram.valueAtPercentile( 50 ) ) / 1e6;
+        const double p99 = double( histogram.valueAtPercentile( 99 ) ) / 1e6;
+        const double max = double( histogram.max() ) / 1e6;
+
+        emit latencyChanged( p50, p99, max );
+        emit p50Changed( p50 );
+        emit p99Changed( p99 );
+        emit maxChanged( max );
+
+        // the statistics are of the last second
+        histogram.reset();
+      }
+    }
+
+  private:
+    LatencyHistogram histogram;
+    QBasicTimer statisticsTimer;
+};
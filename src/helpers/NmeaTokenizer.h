@@ -0,0 +1,311 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include <QByteArray>
+
+// zero-copy tokenizer for NMEA0183 sentences
+// all the fields point directly into the buffer given to NmeaSentence::parse(), so the buffer
+// has to outlive the NmeaSentence. No memory is allocated while parsing; the numeric conversion
+// is done by hand (in the spirit of std::from_chars), so it is locale-independent and doesn't
+// need a QString or a conversion to UTF-16
+
+class NmeaField {
+  public:
+    NmeaField() = default;
+    NmeaField( const char* begin, const char* end )
+      : begin( begin ), end( end ) {}
+
+    int size() const {
+      return int( end - begin );
+    }
+
+    bool isEmpty() const {
+      return begin == end;
+    }
+
+    char at( const int i ) const {
+      return ( i < size() ) ? begin[i] : '\0';
+    }
+
+    bool operator==( const char c ) const {
+      return ( size() == 1 ) && ( *begin == c );
+    }
+
+    NmeaField left( const int n ) const {
+      return NmeaField( begin, ( n < size() ) ? begin + n : end );
+    }
+
+    NmeaField mid( const int n ) const {
+      return NmeaField( ( n < size() ) ? begin + n : end, end );
+    }
+
+    // returns true, if the whole field could be converted
+    // only plain decimal numbers are accepted: [+-]digits[.digits]
+    bool parseDouble( double& value ) const {
+      const char* it = begin;
+      bool negative = false;
+
+      if( it != end && ( *it == '-' || *it == '+' ) ) {
+        negative = ( *it == '-' );
+        ++it;
+      }
+
+      // accumulate all digits in an integer and divide by the power of ten afterwards;
+      // a double is exact up to 2^53, which is enough for all NMEA fields
+      static constexpr uint64_t maxMantissa = ( uint64_t( 1 ) << 53 ) / 10;
+
+      static constexpr double powersOfTen[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8,
+        1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16
+      };
+      static constexpr int maxFractionalDigits = int( sizeof( powersOfTen ) / sizeof( powersOfTen[0] ) ) - 1;
+
+      uint64_t mantissa = 0;
+      int fractionalDigits = 0;
+      bool hasDigits = false;
+      bool inFraction = false;
+
+      for( ; it != end; ++it ) {
+        const char c = *it;
+
+        if( c >= '0' && c <= '9' ) {
+          if( inFraction ) {
+            // the digits after the mantissa is full or after the last power of ten are below the precision of a
+            // double: drop them. Leading zeros of the fraction count, even if the mantissa stays 0
+            if( mantissa < maxMantissa && fractionalDigits < maxFractionalDigits ) {
+              mantissa = mantissa * 10 + uint64_t( c - '0' );
+              ++fractionalDigits;
+            }
+          } else if( mantissa < maxMantissa ) {
+            mantissa = mantissa * 10 + uint64_t( c - '0' );
+          } else {
+            // more digits before the decimal point than a double can hold exactly
+            return false;
+          }
+
+          hasDigits = true;
+        } else if( c == '.' && !inFraction ) {
+          inFraction = true;
+        } else {
+          return false;
+        }
+      }
+
+      if( !hasDigits ) {
+        return false;
+      }
+
+      value = double( mantissa ) / powersOfTen[fractionalDigits];
+
+      if( negative ) {
+        value = -value;
+      }
+
+      return true;
+    }
+
+    // returns defaultValue, if the field is empty or not a number
+    double toDouble( const double defaultValue = 0 ) const {
+      double value = 0;
+
+      if( parseDouble( value ) ) {
+        return value;
+      }
+
+      return defaultValue;
+    }
+
+    // the format is like this: DDMM.MMMMM or DDDMM.MMMMM; degreeDigits is 2 or 3
+    bool toDegrees( const int degreeDigits, double& value ) const {
+      double degrees = 0;
+      double minutes = 0;
+
+      if( size() > degreeDigits &&
+          left( degreeDigits ).parseDouble( degrees ) &&
+          mid( degreeDigits ).parseDouble( minutes ) ) {
+        value = degrees + minutes / 60;
+        return true;
+      }
+
+      return false;
+    }
+
+    // returns the value of two hex digits (like the checksum) or -1 if it isn't valid
+    int toHexByte() const {
+      if( size() != 2 ) {
+        return -1;
+      }
+
+      int high = hexDigitToInt( begin[0] );
+      int low = hexDigitToInt( begin[1] );
+
+      if( high < 0 || low < 0 ) {
+        return -1;
+      }
+
+      return ( high << 4 ) | low;
+    }
+
+  private:
+    static int hexDigitToInt( const char c ) {
+      if( c >= '0' && c <= '9' ) {
+        return c - '0';
+      }
+
+      if( c >= 'A' && c <= 'F' ) {
+        return c - 'A' + 10;
+      }
+
+      if( c >= 'a' && c <= 'f' ) {
+        return c - 'a' + 10;
+      }
+
+      return -1;
+    }
+
+  public:
+    const char* begin = nullptr;
+    const char* end = nullptr;
+};
+
+class NmeaSentence {
+  public:
+    // more fields are ignored; the longest sentences used (GNS, RMC) have less than 16
+    static constexpr int MaxFields = 24;
+
+    enum class Status {
+      Valid,
+      NoChecksum,
+      ChecksumIncorrect,
+      Invalid
+    };
+
+    // parses one line without the line ending
+    Status parse( const char* lineBegin, const char* lineEnd ) {
+      numFields = 0;
+
+      if( lineBegin == lineEnd || ( *lineBegin != '$' && *lineBegin != '!' ) ) {
+        return Status::Invalid;
+      }
+
+      // the checksum is a simple XOR of all chars in the sentence, but without the $ and the checksum itself
+      quint8 checksum = 0;
+      const char* fieldBegin = lineBegin + 1;
+      const char* it = fieldBegin;
+
+      for( ; it != lineEnd && *it != '*'; ++it ) {
+        checksum ^= quint8( *it );
+
+        if( *it == ',' ) {
+          addField( fieldBegin, it );
+          fieldBegin = it + 1;
+        }
+      }
+
+      addField( fieldBegin, it );
+
+      // the first field is the talker id (two chars) and the type of the sentence
+      if( fields[0].size() < 3 ) {
+        return Status::Invalid;
+      }
+
+      if( it == lineEnd ) {
+        return Status::NoChecksum;
+      }
+
+      // *it == '*': the two hex digits of the checksum follow
+      int checksumFromSentence = NmeaField( it + 1, lineEnd ).toHexByte();
+
+      if( checksumFromSentence < 0 ) {
+        return Status::NoChecksum;
+      }
+
+      return ( checksum == checksumFromSentence ) ? Status::Valid : Status::ChecksumIncorrect;
+    }
+
+    // type of the sentence, without the talker id
+    NmeaField type() const {
+      return fields[0].mid( 2 );
+    }
+
+    bool isType( const char* typeToCompare ) const {
+      const NmeaField typeOfSentence = type();
+      const char* it = typeOfSentence.begin;
+
+      for( ; *typeToCompare != '\0'; ++typeToCompare, ++it ) {
+        if( it == typeOfSentence.end || *it != *typeToCompare ) {
+          return false;
+        }
+      }
+
+      return it == typeOfSentence.end;
+    }
+
+    int count() const {
+      return numFields;
+    }
+
+    // index 0 is the talker id + type; returns an empty field if out of range
+    NmeaField field( const int index ) const {
+      if( index < numFields ) {
+        return fields[size_t( index )];
+      }
+
+      return NmeaField();
+    }
+
+  private:
+    void addField( const char* begin, const char* end ) {
+      if( numFields < MaxFields ) {
+        fields[size_t( numFields )] = NmeaField( begin, end );
+        ++numFields;
+      }
+    }
+
+  private:
+    std::array<NmeaField, MaxFields> fields;
+    int numFields = 0;
+};
+
+class NmeaTokenizer {
+  public:
+    // searches the next complete line in buffer, starting at position from
+    // returns the position after the line ending or -1, if there is no complete line
+    // lineBegin/lineEnd point to the line without the trailing "\r\n"
+    static int nextLine( const QByteArray& buffer, const int from, const char*& lineBegin, const char*& lineEnd ) {
+      const int indexOfNewline = buffer.indexOf( '\n', from );
+
+      if( indexOfNewline < 0 ) {
+        return -1;
+      }
+
+      lineBegin = buffer.constData() + from;
+      lineEnd = buffer.constData() + indexOfNewline;
+
+      while( lineEnd != lineBegin && ( *( lineEnd - 1 ) == '\r' ) ) {
+        --lineEnd;
+      }
+
+      return indexOfNewline + 1;
+    }
+};
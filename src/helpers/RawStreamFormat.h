@@ -0,0 +1,402 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QDebug>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+#include "SpscRingBuffer.h"
+
+// binary format to record raw streams (like the data received by a serial port or an UDP socket)
+// the file starts with FileMagic and is only ever appended to. It consists of records, each with a RecordHeader
+// followed by the payload. The timestamps are from a steady clock in ns.
+// On closing, an index record is written, followed by a trailer pointing to it. The index has an entry
+// for the first record of every chunk of about ChunkSize bytes. A file without a valid trailer (after a crash
+// for example) can still be read by scanning the records.
+namespace RawStream {
+  constexpr char FileMagic[8] = { 'Q', 'O', 'G', 'R', 'A', 'W', '0', '1' };
+  constexpr char IndexMagic[8] = { 'Q', 'O', 'G', 'I', 'D', 'X', '0', '1' };
+
+  constexpr qint64 ChunkSize = 64 * 1024;
+
+  enum class RecordType : uint32_t {
+    Data = 0,
+    Index = 1
+  };
+
+#pragma pack(push, 1)
+  struct RecordHeader {
+    uint32_t length;
+    uint32_t type;
+    int64_t timestamp;
+  };
+
+  struct IndexEntry {
+    int64_t timestamp;
+    int64_t offset;
+  };
+
+  struct Trailer {
+    int64_t indexOffset;
+    char magic[8];
+  };
+#pragma pack(pop)
+
+  static_assert( sizeof( RecordHeader ) == 16, "RecordHeader has to be packed" );
+  static_assert( sizeof( IndexEntry ) == 16, "IndexEntry has to be packed" );
+  static_assert( sizeof( Trailer ) == 16, "Trailer has to be packed" );
+
+#if Q_BYTE_ORDER != Q_LITTLE_ENDIAN
+#error "The raw stream format is little-endian and read and written in native byte order"
+#endif
+
+  inline bool hasFileMagic( const char* data, const qint64 size ) {
+    return size >= qint64( sizeof( FileMagic ) ) && std::memcmp( data, FileMagic, sizeof( FileMagic ) ) == 0;
+  }
+
+  // reads a recording in memory, for example a memory mapped file
+  class Reader {
+    public:
+      struct Record {
+        qint64 timestamp = 0;
+        qint64 offset = 0;
+        int length = 0;
+      };
+
+    public:
+      bool open( const char* data, const qint64 size ) {
+        this->data = data;
+        this->size = size;
+        position = sizeof( FileMagic );
+        index.clear();
+
+        if( !hasFileMagic( data, size ) ) {
+          return false;
+        }
+
+        readIndex( data, size, index );
+        return true;
+      }
+
+      bool hasIndex() const {
+        return !index.empty();
+      }
+
+      // returns the next data record; the payload is at data + record.offset
+      bool next( Record& record ) {
+        RecordHeader header;
+
+        while( position + qint64( sizeof( RecordHeader ) ) <= size ) {
+          std::memcpy( &header, data + position, sizeof( RecordHeader ) );
+
+          const qint64 payloadOffset = position + qint64( sizeof( RecordHeader ) );
+
+          // truncated record: the end of the recording
+          if( payloadOffset + qint64( header.length ) > size ) {
+            return false;
+          }
+
+          position = payloadOffset + qint64( header.length );
+
+          if( header.type == uint32_t( RecordType::Data ) ) {
+            record.timestamp = header.timestamp;
+            record.offset = payloadOffset;
+            record.length = int( header.length );
+            return true;
+          }
+
+          // the trailer follows the last index record
+          if( header.type == uint32_t( RecordType::Index ) && isTrailerAt( position ) ) {
+            position += qint64( sizeof( Trailer ) );
+          }
+        }
+
+        return false;
+      }
+
+      // positions the reader, so next() returns the first record with a timestamp not before the given one
+      void seek( const qint64 timestamp ) {
+        position = sizeof( FileMagic );
+
+        // jump to the last chunk starting before the timestamp, then scan linearly
+        if( !index.empty() ) {
+          auto it = std::upper_bound( index.cbegin(), index.cend(), timestamp, []( qint64 timestamp, const IndexEntry & entry ) {
+            return timestamp < entry.timestamp;
+          } );
+
+          if( it != index.cbegin() ) {
+            position = ( it - 1 )->offset;
+          }
+        }
+
+        Record record;
+        qint64 lastPosition = position;
+
+        while( next( record ) ) {
+          if( record.timestamp >= timestamp ) {
+            position = lastPosition;
+            return;
+          }
+
+          lastPosition = position;
+        }
+      }
+
+      // timestamp of the last data record, 0 if there is none; with an index, only the last chunk is scanned
+      // the position of the reader is kept
+      qint64 lastTimestamp() {
+        const qint64 savedPosition = position;
+        position = index.empty() ? qint64( sizeof( FileMagic ) ) : index.back().offset;
+
+        Record record;
+        qint64 timestamp = 0;
+
+        while( next( record ) ) {
+          timestamp = record.timestamp;
+        }
+
+        position = savedPosition;
+        return timestamp;
+      }
+
+      // reads the index of a file with a valid trailer
+      static bool readIndex( const char* data, const qint64 size, std::vector<IndexEntry>& index ) {
+        if( size < qint64( sizeof( FileMagic ) + sizeof( RecordHeader ) + sizeof( Trailer ) ) ) {
+          return false;
+        }
+
+        Trailer trailer;
+        std::memcpy( &trailer, data + size - qint64( sizeof( Trailer ) ), sizeof( Trailer ) );
+
+        if( std::memcmp( trailer.magic, IndexMagic, sizeof( IndexMagic ) ) != 0 ||
+            trailer.indexOffset < qint64( sizeof( FileMagic ) ) ||
+            trailer.indexOffset + qint64( sizeof( RecordHeader ) ) > size ) {
+          return false;
+        }
+
+        RecordHeader header;
+        std::memcpy( &header, data + trailer.indexOffset, sizeof( RecordHeader ) );
+
+        const qint64 entriesOffset = trailer.indexOffset + qint64( sizeof( RecordHeader ) );
+
+        if( header.type != uint32_t( RecordType::Index ) ||
+            entriesOffset + qint64( header.length ) + qint64( sizeof( Trailer ) ) != size ) {
+          return false;
+        }
+
+        index.resize( header.length / sizeof( IndexEntry ) );
+        std::memcpy( index.data(), data + entriesOffset, index.size() * sizeof( IndexEntry ) );
+
+        return true;
+      }
+
+    private:
+      bool isTrailerAt( const qint64 offset ) const {
+        return offset + qint64( sizeof( Trailer ) ) <= size &&
+               std::memcmp( data + offset + offsetof( Trailer, magic ), IndexMagic, sizeof( IndexMagic ) ) == 0;
+      }
+
+    private:
+      const char* data = nullptr;
+      qint64 size = 0;
+      qint64 position = 0;
+      std::vector<IndexEntry> index;
+  };
+
+  // appends records to a file on a background thread
+  // write() is wait-free and can be called from exactly one thread; the data is copied (implicitly shared) to
+  // a ring buffer and written to the file by the writer thread, so disk latency never stalls the caller
+  class Writer {
+    public:
+      explicit Writer( size_t numRecords = 1024 )
+        : ring( numRecords ) {}
+
+      ~Writer() {
+        close();
+      }
+
+      bool isOpen() const {
+        return thread.joinable();
+      }
+
+      bool open( const QString& filename ) {
+        close();
+
+        file.setFileName( filename );
+
+        if( !file.open( QIODevice::ReadWrite ) ) {
+          return false;
+        }
+
+        index.clear();
+
+        if( file.size() == 0 ) {
+          file.write( FileMagic, sizeof( FileMagic ) );
+        } else {
+          // keep the index of the previous recordings in the file, so the new index covers everything
+          const qint64 size = file.size();
+          const uchar* data = file.map( 0, size );
+
+          if( data == nullptr || !hasFileMagic( reinterpret_cast<const char*>( data ), size ) ) {
+            qDebug() << "RawStream::Writer: not a raw stream recording" << filename;
+            file.close();
+            return false;
+          }
+
+          Reader::readIndex( reinterpret_cast<const char*>( data ), size, index );
+          file.unmap( const_cast<uchar*>( data ) );
+          file.seek( size );
+        }
+
+        lastIndexedOffset = -ChunkSize;
+        running = true;
+        thread = std::thread( &Writer::run, this );
+
+        return true;
+      }
+
+      void close() {
+        if( thread.joinable() ) {
+          {
+            std::lock_guard<std::mutex> lock( mutex );
+            running = false;
+          }
+
+          condition.notify_one();
+          thread.join();
+
+          writeIndex();
+          file.close();
+        }
+      }
+
+      // returns false if the ring buffer is full and the record is lost
+      bool write( const qint64 timestamp, const QByteArray& data ) {
+        Record* record = ring.beginWrite();
+
+        if( record == nullptr ) {
+          ++overruns;
+          return false;
+        }
+
+        record->timestamp = timestamp;
+        record->data = data;
+        ring.commitWrite();
+
+        condition.notify_one();
+
+        return true;
+      }
+
+    public:
+      std::atomic<uint64_t> overruns{0};
+      std::atomic<uint64_t> bytesWritten{0};
+
+    private:
+      struct Record {
+        qint64 timestamp = 0;
+        QByteArray data;
+      };
+
+      void run() {
+        std::unique_lock<std::mutex> lock( mutex );
+
+        for( ;; ) {
+          const bool stop = !running;
+          lock.unlock();
+
+          bool written = false;
+
+          while( Record* record = ring.front() ) {
+            writeRecord( *record );
+            record->data.clear();
+            ring.pop();
+            written = true;
+          }
+
+          if( written ) {
+            file.flush();
+          }
+
+          lock.lock();
+
+          if( stop ) {
+            break;
+          }
+
+          // the timeout catches a notification between draining and waiting
+          condition.wait_for( lock, std::chrono::milliseconds( 100 ) );
+        }
+      }
+
+      void writeRecord( const Record& record ) {
+        const qint64 offset = file.pos();
+
+        if( offset - lastIndexedOffset >= ChunkSize ) {
+          index.push_back( IndexEntry{ record.timestamp, offset } );
+          lastIndexedOffset = offset;
+        }
+
+        const RecordHeader header{ uint32_t( record.data.size() ), uint32_t( RecordType::Data ), record.timestamp };
+        file.write( reinterpret_cast<const char*>( &header ), sizeof( RecordHeader ) );
+        file.write( record.data );
+
+        bytesWritten += sizeof( RecordHeader ) + uint64_t( record.data.size() );
+      }
+
+      void writeIndex() {
+        const qint64 offset = file.pos();
+
+        const RecordHeader header{ uint32_t( index.size() * sizeof( IndexEntry ) ), uint32_t( RecordType::Index ), 0 };
+        file.write( reinterpret_cast<const char*>( &header ), sizeof( RecordHeader ) );
+        file.write( reinterpret_cast<const char*>( index.data() ), qint64( index.size() * sizeof( IndexEntry ) ) );
+
+        Trailer trailer;
+        trailer.indexOffset = offset;
+        std::memcpy( trailer.magic, IndexMagic, sizeof( IndexMagic ) );
+        file.write( reinterpret_cast<const char*>( &trailer ), sizeof( Trailer ) );
+      }
+
+    private:
+      QFile file;
+      SpscRingBuffer<Record> ring;
+
+      std::thread thread;
+      std::mutex mutex;
+      std::condition_variable condition;
+      bool running = false;
+
+      // only used by the writer thread while it runs
+      std::vector<IndexEntry> index;
+      qint64 lastIndexedOffset = 0;
+  };
+}
@@ -0,0 +1,280 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <QObject>
+#include <QBasicTimer>
+#include <QCoreApplication>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QTimerEvent>
+#include <QtDebug>
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <utility>
+
+class SimulationTimer;
+
+// the time of the simulation; ns since the start of the application
+// In realtime mode, this is the steady clock and SimulationTimer is a QBasicTimer.
+// In virtual mode, the time only advances to the next due SimulationTimer: the clock jumps to its deadline,
+// delivers the timer event and returns to the event loop, so the queued events are handled before the next
+// timer. A simulation then runs as fast as the blocks can process it, with the same results every run.
+// The mode has to be set before the first timer is started; the blocks using the virtual time have to run
+// in the thread of the clock to be deterministic
+class SimulationClock : public QObject {
+    Q_OBJECT
+
+  public:
+    enum class Mode {
+      Realtime,
+      Virtual
+    };
+
+    static SimulationClock& instance() {
+      static SimulationClock clock;
+      return clock;
+    }
+
+    static qint64 now() {
+      return instance().nsecsElapsed();
+    }
+
+    Mode mode() const {
+      return clockMode;
+    }
+
+    void setMode( const Mode mode ) {
+      QMutexLocker locker( &mutex );
+
+      if( !schedule.empty() ) {
+        qWarning() << "SimulationClock: mode changed with active timers";
+      }
+
+      clockMode = mode;
+    }
+
+    qint64 nsecsElapsed() const {
+      if( clockMode == Mode::Virtual ) {
+        return virtualTime.load( std::memory_order_relaxed );
+      }
+
+      return steadyNow() - startOfClock;
+    }
+
+    // emits finished() when the given time is reached; 0 to run forever
+    void setEndTime( const qint64 endTime ) {
+      this->endTime = endTime;
+
+      if( clockMode == Mode::Realtime ) {
+        endTimer.stop();
+
+        if( endTime > 0 ) {
+          endTimer.start( int( qMax( endTime - nsecsElapsed(), qint64( 0 ) ) / 1000000 ), Qt::PreciseTimer, this );
+        }
+      }
+    }
+
+  signals:
+    void finished();
+
+  protected:
+    void timerEvent( QTimerEvent* event ) override {
+      if( event->timerId() == endTimer.timerId() ) {
+        endTimer.stop();
+        emit finished();
+      }
+
+      if( event->timerId() == stepTimer.timerId() ) {
+        step();
+      }
+    }
+
+  private:
+    friend class SimulationTimer;
+
+    using Key = std::pair<qint64, quint64>;
+
+    SimulationClock()
+      : startOfClock( steadyNow() ) {}
+
+    static qint64 steadyNow() {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     std::chrono::steady_clock::now().time_since_epoch() ).count();
+    }
+
+    inline void addTimer( SimulationTimer* timer );
+    inline void removeTimer( SimulationTimer* timer );
+    inline void step();
+
+    void startStepping() {
+      // the step timer belongs to the thread of the clock
+      if( QThread::currentThread() == thread() ) {
+        if( !stepTimer.isActive() ) {
+          stepTimer.start( 0, this );
+        }
+      } else {
+        QMetaObject::invokeMethod( this, [this] {
+          if( !stepTimer.isActive() ) {
+            stepTimer.start( 0, this );
+          }
+        }, Qt::QueuedConnection );
+      }
+    }
+
+  private:
+    Mode clockMode = Mode::Realtime;
+    const qint64 startOfClock;
+    std::atomic<qint64> virtualTime{0};
+    qint64 endTime = 0;
+
+    QBasicTimer stepTimer;
+    QBasicTimer endTimer;
+
+    // the due timers sorted by deadline; the sequence keeps timers with the same deadline in the order
+    // they were started
+    QMutex mutex;
+    std::map<Key, SimulationTimer*> schedule;
+    quint64 nextSequence = 0;
+    int nextVirtualTimerId = -1;
+};
+
+// a QBasicTimer following the time of SimulationClock; use it like a QBasicTimer: the receiver gets a
+// QTimerEvent with timerId() on every timeout
+class SimulationTimer {
+  public:
+    SimulationTimer() = default;
+
+    ~SimulationTimer() {
+      stop();
+    }
+
+    SimulationTimer( const SimulationTimer& ) = delete;
+    SimulationTimer& operator=( const SimulationTimer& ) = delete;
+
+    void start( const int msec, QObject* receiver ) {
+      start( msec, Qt::CoarseTimer, receiver );
+    }
+
+    void start( const int msec, const Qt::TimerType timerType, QObject* receiver ) {
+      auto& clock = SimulationClock::instance();
+
+      if( clock.mode() == SimulationClock::Mode::Virtual ) {
+        stop();
+
+        this->receiver = receiver;
+        interval = qint64( qMax( msec, 0 ) ) * 1000000;
+        clock.addTimer( this );
+        active = true;
+      } else {
+        timer.start( msec, timerType, receiver );
+      }
+    }
+
+    void stop() {
+      if( active ) {
+        SimulationClock::instance().removeTimer( this );
+        active = false;
+      }
+
+      timer.stop();
+    }
+
+    bool isActive() const {
+      return active || timer.isActive();
+    }
+
+    int timerId() const {
+      return active ? virtualId : timer.timerId();
+    }
+
+  private:
+    friend class SimulationClock;
+
+    QBasicTimer timer;
+
+    // virtual mode
+    bool active = false;
+    int virtualId = 0;
+    qint64 interval = 0;
+    QObject* receiver = nullptr;
+    SimulationClock::Key key;
+};
+
+void SimulationClock::addTimer( SimulationTimer* timer ) {
+  QMutexLocker locker( &mutex );
+
+  // negative ids don't collide with the ones of QBasicTimer
+  if( timer->virtualId == 0 ) {
+    timer->virtualId = nextVirtualTimerId--;
+  }
+
+  timer->key = Key( virtualTime.load( std::memory_order_relaxed ) + timer->interval, nextSequence++ );
+  schedule.emplace( timer->key, timer );
+
+  locker.unlock();
+  startStepping();
+}
+
+void SimulationClock::removeTimer( SimulationTimer* timer ) {
+  QMutexLocker locker( &mutex );
+  schedule.erase( timer->key );
+}
+
+void SimulationClock::step() {
+  QMutexLocker locker( &mutex );
+
+  if( schedule.empty() ) {
+    stepTimer.stop();
+    return;
+  }
+
+  auto first = schedule.begin();
+  SimulationTimer* timer = first->second;
+  const qint64 deadline = first->first.first;
+
+  if( endTime > 0 && deadline > endTime ) {
+    stepTimer.stop();
+    virtualTime.store( endTime, std::memory_order_relaxed );
+    locker.unlock();
+    emit finished();
+    return;
+  }
+
+  virtualTime.store( deadline, std::memory_order_relaxed );
+
+  // like QBasicTimer, the timer repeats until stopped; reschedule it before the receiver can stop or restart it
+  schedule.erase( first );
+  timer->key = Key( deadline + timer->interval, nextSequence++ );
+  schedule.emplace( timer->key, timer );
+
+  QObject* receiver = timer->receiver;
+  const int timerId = timer->virtualId;
+  locker.unlock();
+
+  if( receiver->thread() == QThread::currentThread() ) {
+    QTimerEvent event( timerId );
+    QCoreApplication::sendEvent( receiver, &event );
+  } else {
+    QCoreApplication::postEvent( receiver, new QTimerEvent( timerId ) );
+  }
+}
@@ -0,0 +1,95 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// lock-free ring buffer for exactly one producer and one consumer thread
+// the slots are allocated once and reused, so the elements can keep their memory (like a QByteArray
+// with reserved capacity) between uses
+template<typename T>
+class SpscRingBuffer {
+  public:
+    // the capacity is rounded up to the next power of two
+    explicit SpscRingBuffer( size_t capacity )
+      : mask( roundUpToPowerOfTwo( capacity ) - 1 ),
+        slots( mask + 1 ) {}
+
+    SpscRingBuffer( const SpscRingBuffer& ) = delete;
+    SpscRingBuffer& operator=( const SpscRingBuffer& ) = delete;
+
+    size_t capacity() const {
+      return mask + 1;
+    }
+
+    // producer: returns the next free slot or nullptr if the buffer is full
+    T* beginWrite() {
+      const size_t currentHead = head.load( std::memory_order_relaxed );
+
+      if( currentHead - tail.load( std::memory_order_acquire ) > mask ) {
+        return nullptr;
+      }
+
+      return &slots[currentHead & mask];
+    }
+
+    // producer: publishes the slot returned by beginWrite()
+    void commitWrite() {
+      head.store( head.load( std::memory_order_relaxed ) + 1, std::memory_order_release );
+    }
+
+    // consumer: returns the oldest element or nullptr if the buffer is empty
+    T* front() {
+      const size_t currentTail = tail.load( std::memory_order_relaxed );
+
+      if( currentTail == head.load( std::memory_order_acquire ) ) {
+        return nullptr;
+      }
+
+      return &slots[currentTail & mask];
+    }
+
+    // consumer: releases the element returned by front()
+    void pop() {
+      tail.store( tail.load( std::memory_order_relaxed ) + 1, std::memory_order_release );
+    }
+
+  private:
+    static size_t roundUpToPowerOfTwo( size_t value ) {
+      size_t result = 1;
+
+      while( result < value ) {
+        result <<= 1;
+      }
+
+      return result;
+    }
+
+  private:
+    const size_t mask;
+    std::vector<T> slots;
+
+    // keep the indices of the producer and the consumer on different cache lines
+    char padding1[64];
+    std::atomic<size_t> head{0};
+    char padding2[64];
+    std::atomic<size_t> tail{0};
+};
@@ -0,0 +1,254 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include <QByteArray>
+#include <QtEndian>
+
+// the payloads are decoded by copying them over packed structs, which only works on little endian machines
+#if Q_BYTE_ORDER != Q_LITTLE_ENDIAN
+#error "UbxFramer only supports little endian platforms"
+#endif
+
+// https://www.u-blox.com/de/product/zed-f9p-module -> interface manual
+namespace Ubx {
+  enum class MessageClass : uint8_t {
+    Nav = 0x01
+  };
+
+  enum class NavMessageId : uint8_t {
+    Pvt = 0x07,
+    HpPosLlh = 0x14,
+    RelPosNed = 0x3c
+  };
+
+#pragma pack(push, 1)
+  struct NavHpPosLlh {
+    uint8_t version;
+    uint8_t reserved1[2];
+    uint8_t flags;
+    uint32_t iTOW;        // ms
+    int32_t lon;          // 1e-7 deg
+    int32_t lat;          // 1e-7 deg
+    int32_t height;       // mm
+    int32_t hMSL;         // mm
+    int8_t lonHp;         // 1e-9 deg
+    int8_t latHp;         // 1e-9 deg
+    int8_t heightHp;      // 0.1 mm
+    int8_t hMSLHp;        // 0.1 mm
+    uint32_t hAcc;        // 0.1 mm
+    uint32_t vAcc;        // 0.1 mm
+  };
+
+  struct NavRelPosNed {
+    uint8_t version;
+    uint8_t reserved1;
+    uint16_t refStationId;
+    uint32_t iTOW;        // ms
+    int32_t relPosN;      // cm
+    int32_t relPosE;      // cm
+    int32_t relPosD;      // cm
+    int32_t relPosLength; // cm
+    int32_t relPosHeading;// 1e-5 deg
+    uint8_t reserved2[4];
+    int8_t relPosHPN;     // 0.1 mm
+    int8_t relPosHPE;     // 0.1 mm
+    int8_t relPosHPD;     // 0.1 mm
+    int8_t relPosHPLength;// 0.1 mm
+    uint32_t accN;        // 0.1 mm
+    uint32_t accE;        // 0.1 mm
+    uint32_t accD;        // 0.1 mm
+    uint32_t accLength;   // 0.1 mm
+    uint32_t accHeading;  // 1e-5 deg
+    uint8_t reserved3[4];
+    uint32_t flags;
+  };
+
+  struct NavPvt {
+    uint32_t iTOW;        // ms
+    uint16_t year;
+    uint8_t month;
+    uint8_t day;
+    uint8_t hour;
+    uint8_t min;
+    uint8_t sec;
+    uint8_t valid;
+    uint32_t tAcc;        // ns
+    int32_t nano;         // ns
+    uint8_t fixType;
+    uint8_t flags;
+    uint8_t flags2;
+    uint8_t numSV;
+    int32_t lon;          // 1e-7 deg
+    int32_t lat;          // 1e-7 deg
+    int32_t height;       // mm
+    int32_t hMSL;         // mm
+    uint32_t hAcc;        // mm
+    uint32_t vAcc;        // mm
+    int32_t velN;         // mm/s
+    int32_t velE;         // mm/s
+    int32_t velD;         // mm/s
+    int32_t gSpeed;       // mm/s
+    int32_t headMot;      // 1e-5 deg
+    uint32_t sAcc;        // mm/s
+    uint32_t headAcc;     // 1e-5 deg
+    uint16_t pDOP;        // 0.01
+    uint8_t flags3;
+    uint8_t reserved1[5];
+    int32_t headVeh;      // 1e-5 deg
+    int16_t magDec;       // 1e-2 deg
+    uint16_t magAcc;      // 1e-2 deg
+  };
+#pragma pack(pop)
+
+  static_assert( sizeof( NavHpPosLlh ) == 36, "UBX-NAV-HPPOSLLH has to be 36 bytes" );
+  static_assert( sizeof( NavRelPosNed ) == 64, "UBX-NAV-RELPOSNED has to be 64 bytes" );
+  static_assert( sizeof( NavPvt ) == 92, "UBX-NAV-PVT has to be 92 bytes" );
+}
+
+// finds the UBX frames in a stream of bytes
+// the whole chunk of received data is scanned at once for the sync chars; only an incomplete
+// frame at the end is kept in an internal buffer for the next call
+class UbxFramer {
+  public:
+    struct Message {
+      uint8_t messageClass;
+      uint8_t messageId;
+      uint16_t length;
+      const char* payload;
+
+      bool is( Ubx::MessageClass messageClassToCompare, Ubx::NavMessageId messageIdToCompare ) const {
+        return messageClass == uint8_t( messageClassToCompare ) && messageId == uint8_t( messageIdToCompare );
+      }
+
+      // copies the payload over a packed struct; returns false if the length doesn't match
+      template<typename T>
+      bool decode( T& value ) const {
+        if( length != sizeof( T ) ) {
+          return false;
+        }
+
+        std::memcpy( &value, payload, sizeof( T ) );
+        return true;
+      }
+    };
+
+    // header: 2 sync chars, class, id and 2 bytes length; trailer: 2 bytes checksum
+    static constexpr int HeaderSize = 6;
+    static constexpr int ChecksumSize = 2;
+    // bigger frames are considered a false sync
+    static constexpr int MaxPayloadSize = 1024;
+
+    // calls handler( const Message& ) for every frame with a correct checksum
+    template<typename Handler>
+    void parse( const QByteArray& data, Handler handler ) {
+      // only copy the data if there is an incomplete frame from the last call
+      if( buffer.isEmpty() ) {
+        const int consumed = parse( data.constData(), data.size(), handler );
+        buffer = data.mid( consumed );
+      } else {
+        buffer.append( data );
+        const int consumed = parse( buffer.constData(), buffer.size(), handler );
+        buffer.remove( 0, consumed );
+      }
+    }
+
+    int bytesBuffered() const {
+      return buffer.size();
+    }
+
+    int checksumErrors = 0;
+
+  private:
+    // returns the number of bytes, that can be removed from the buffer
+    template<typename Handler>
+    int parse( const char* data, const int size, Handler& handler ) {
+      int position = 0;
+
+      while( position < size ) {
+        const auto* sync = static_cast<const char*>( std::memchr( data + position, SyncChar1, size_t( size - position ) ) );
+
+        if( sync == nullptr ) {
+          return size;
+        }
+
+        position = int( sync - data );
+
+        // not enough data to read the header
+        if( position + HeaderSize > size ) {
+          return position;
+        }
+
+        if( uint8_t( data[position + 1] ) != SyncChar2 ) {
+          ++position;
+          continue;
+        }
+
+        const uint16_t length = qFromLittleEndian<quint16>( data + position + 4 );
+
+        if( length > MaxPayloadSize ) {
+          ++position;
+          continue;
+        }
+
+        const int frameSize = HeaderSize + length + ChecksumSize;
+
+        // incomplete frame: wait for more data
+        if( position + frameSize > size ) {
+          return position;
+        }
+
+        // 8-bit Fletcher algorithm over class, id, length and payload
+        uint8_t checksumA = 0;
+        uint8_t checksumB = 0;
+
+        for( const char* it = data + position + 2, *end = data + position + HeaderSize + length; it != end; ++it ) {
+          checksumA += uint8_t( *it );
+          checksumB += checksumA;
+        }
+
+        if( checksumA == uint8_t( data[position + HeaderSize + length] ) &&
+            checksumB == uint8_t( data[position + HeaderSize + length + 1] ) ) {
+          Message message;
+          message.messageClass = uint8_t( data[position + 2] );
+          message.messageId = uint8_t( data[position + 3] );
+          message.length = length;
+          message.payload = data + position + HeaderSize;
+
+          handler( message );
+
+          position += frameSize;
+        } else {
+          ++checksumErrors;
+          ++position;
+        }
+      }
+
+      return position;
+    }
+
+  private:
+    static constexpr char SyncChar1 = char( 0xb5 );
+    static constexpr uint8_t SyncChar2 = 0x62;
+
+    QByteArray buffer;
+};
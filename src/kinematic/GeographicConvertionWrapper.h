@@ -23,6 +23,9 @@
 #include <GeographicLib/UTMUPS.hpp>
 #include <GeographicLib/Ellipsoid.hpp>
 
+#include <QMutex>
+#include <QMutexLocker>
+
 // NOTE: QtOpenGuidance uses the coordinate system for the vehicle according to ISO 8855:2011(E)
 // (Y left, X forward, Z up), but the coordinate system of the geographic conversions
 // is another one: X east, Y north and Z up. As this is the only code that uses both,
@@ -33,6 +36,7 @@ using namespace std;
 using namespace GeographicLib;
 
 // an instance of this class gets shared across all the blocks, so the conversions are the same everywhere
+// the blocks can run on different threads, so the conversions are serialised
 class GeographicConvertionWrapper {
   public:
 
@@ -40,8 +44,10 @@ class GeographicConvertionWrapper {
     }
 
     void Forward( const double latitude, const double longitude, const double height, double& x, double& y, double& z ) {
+      QMutexLocker locker( &mutex );
+
       if( !isLatLonOffsetSet ) {
-        Reset( latitude, longitude, height );
+        resetUnlocked( latitude, longitude, height );
 
         x = 0;
         y = 0;
@@ -67,8 +73,10 @@ class GeographicConvertionWrapper {
     }
 
     void Forward( const double latitude, const double longitude, double& x, double& y, double& z ) {
+      QMutexLocker locker( &mutex );
+
       if( !isLatLonOffsetSet ) {
-        Reset( latitude, longitude, height0TM );
+        resetUnlocked( latitude, longitude, height0TM );
 
         x = 0;
         y = 0;
@@ -89,6 +97,8 @@ class GeographicConvertionWrapper {
     }
 
     void Reverse( const double x, const double y, const double z, double& latitude, double& longitude, double& height ) {
+      QMutexLocker locker( &mutex );
+
       if( isLatLonOffsetSet ) {
         if( useTM ) {
           TransverseMercator::UTM().Reverse( lon0TM, -y, x + falseNorthingTM, latitude, longitude );
@@ -105,6 +115,8 @@ class GeographicConvertionWrapper {
     }
 
     void Reverse( const double x, const double y, double& latitude, double& longitude, double& height ) {
+      QMutexLocker locker( &mutex );
+
       if( isLatLonOffsetSet ) {
         if( useTM ) {
           TransverseMercator::UTM().Reverse( lon0TM, -y, x + falseNorthingTM, latitude, longitude );
@@ -121,6 +133,20 @@ class GeographicConvertionWrapper {
     }
 
     void Reset( const double latitude, const double longitude, const double height ) {
+      QMutexLocker locker( &mutex );
+
+      resetUnlocked( latitude, longitude, height );
+    }
+
+    // transverse mercator or local cartesian coordinates
+    void setUseTM( const bool useTM ) {
+      QMutexLocker locker( &mutex );
+
+      this->useTM = useTM;
+    }
+
+  private:
+    void resetUnlocked( const double latitude, const double longitude, const double height ) {
       double y;
       lon0TM = longitude;
       TransverseMercator::UTM().Forward( lon0TM, latitude, longitude, y, falseNorthingTM );
@@ -133,13 +159,13 @@ class GeographicConvertionWrapper {
       isLatLonOffsetSet = true;
     }
 
-  public:
-    bool useTM = true;
-
   private:
+    QMutex mutex;
+
     LocalCartesian _lc;
 
     bool isLatLonOffsetSet = false;
+    bool useTM = true;
 
     double falseNorthingTM = 0;
     double lon0TM = 0;
@@ -18,94 +18,53 @@
 
 #include "PathPrimitive.h"
 
-#include <QObject>
+#include <iostream>
 
-#include <QLineF>
-#include <QPointF>
-#include <QtMath>
-
-#include "../cgalKernel.h"
-
-#include <QDebug>
-
-void PathPrimitive::print() {
-  std::cout << "PathPrimitive" << std::endl;
-}
-
-void PathPrimitiveLine::reverse() {
-  line = line.opposite();
-}
-void PathPrimitiveSegment::reverse() {
-  segment = segment.opposite();
-}
-
-double PathPrimitiveSegment::distanceToPoint( const Point_2& point ) {
+double PathPrimitiveSegment::distanceToPoint( const Point_2& point ) const {
   Point_2 ortogonalProjection = segment.supporting_line().projection( point );
-  double distance = sqrt( CGAL::squared_distance( ortogonalProjection, point ) );
-
-  std::cout << "s:" << segment << "p:" << point << "op:" << ortogonalProjection << std::endl;
-
-  qDebug() << "Distance:" << distance;
 
   if( segment.collinear_has_on( ortogonalProjection ) ) {
-    qDebug() << "segment.has_on";
-    return distance;
+    return std::sqrt( CGAL::squared_distance( ortogonalProjection, point ) );
   } else {
     double distToSource = CGAL::squared_distance( point, segment.source() );
     double distToTarget = CGAL::squared_distance( point, segment.target() );
-    qDebug() << distToSource << distToTarget;
 
     if( distToSource < distToTarget ) {
-      return sqrt( distToSource );
+      return std::sqrt( distToSource );
     } else {
-      return sqrt( distToTarget );
+      return std::sqrt( distToTarget );
     }
   }
 }
 
-void PathPrimitiveSegment::print() {
+void PathPrimitiveSegment::print() const {
   std::cout << "PathPrimitiveSegment: " << segment << std::endl;
 }
 
-double PathPrimitiveLine::distanceToPoint( const Point_2& point ) {
-  Point_2 ortogonalProjection = line.projection( point );
-  double distance = sqrt( CGAL::squared_distance( ortogonalProjection, point ) );
-
-  std::cout << "l:" << line << "p:" << point << "op:" << ortogonalProjection << std::endl;
-
-  qDebug() << "Distance:" << distance;
-
-  return distance;
+double PathPrimitiveLine::distanceToPoint( const Point_2& point ) const {
+  return std::sqrt( CGAL::squared_distance( line, point ) );
 }
 
-void PathPrimitiveLine::print() {
+void PathPrimitiveLine::print() const {
   std::cout << "PathPrimitiveLine: " << line << std::endl;
 }
 
-//qreal PathPrimitiveCircle::distanceToPoint( const Point_2& ) {
-//  return 0;
-//}
+namespace {
+  class DistanceToPointVisitor : public boost::static_visitor<double> {
+    public:
+      explicit DistanceToPointVisitor( const Point_2& point )
+        : point( point ) {}
 
-const PathPrimitiveLine* PathPrimitive::castToLine() {
-  if( getType() == Type::Line ) {
-    return static_cast<PathPrimitiveLine*>( this );
-  } else {
-    return nullptr;
-  }
-}
+      template<typename T>
+      double operator()( const T& primitive ) const {
+        return primitive.distanceToPoint( point );
+      }
 
-const PathPrimitiveSegment* PathPrimitive::castToSegment() {
-  if( getType() == Type::Segment ) {
-    return static_cast<PathPrimitiveSegment*>( this );
-  } else {
-    return nullptr;
-  }
+    private:
+      const Point_2& point;
+  };
 }
 
-//const PathPrimitiveCircle* PathPrimitive::castToCircle() {
-//  if( getType() == Type::Circle ) {
-//    return static_cast<PathPrimitiveCircle*>( this );
-//  } else {
-//    return nullptr;
-//  }
-//}
+double distanceToPoint( const PathPrimitive& primitive, const Point_2& point ) {
+  return boost::apply_visitor( DistanceToPointVisitor( point ), primitive );
+}
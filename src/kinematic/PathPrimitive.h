@@ -20,127 +20,68 @@
 
 #include "../cgalKernel.h"
 
-#include <QDebug>
+#include <boost/variant.hpp>
 
-class PathPrimitiveLine;
-class PathPrimitiveSegment;
-class PathPrimitiveCircle;
-
-
-class PathPrimitive {
-  public:
-    PathPrimitive() {}
-
-    PathPrimitive( bool anyDirection, double implementWidth, int32_t passNumber )
-      : anyDirection( anyDirection ), implementWidth( implementWidth ), passNumber( passNumber ) {}
-
-    virtual ~PathPrimitive() {}
-
-    enum class Type : uint8_t {
-      Base = 0,
-      Line,
-      Segment,
-      Circle
-    };
-
-    virtual Type getType() {
-      return Type::Base;
-    }
-
-    const PathPrimitiveLine* castToLine();
-    const PathPrimitiveSegment* castToSegment();
-//    const PathPrimitiveCircle* castToCircle();
+// the primitives are plain values without virtual functions: a plan keeps them in one
+// contiguous vector of variants, which is walked without chasing pointers
 
+class PathPrimitiveLine {
   public:
-    virtual double distanceToPoint( const Point_2& point ) = 0;
-    virtual void print();
-
-  public:
-    bool anyDirection = false;
-    double implementWidth = 0;
-    int32_t passNumber = 0;
-};
-
-class PathPrimitiveLine : public PathPrimitive {
-  public:
-    PathPrimitiveLine()
-      : PathPrimitive() {}
+    PathPrimitiveLine() {}
 
     PathPrimitiveLine( const Line_2& line, double implementWidth, bool anyDirection, int32_t passNumber )
-      : PathPrimitive( anyDirection, implementWidth, passNumber ), line( line ) {}
-
-    virtual Type getType() override {
-      return Type::Line;
-    }
+      : line( line ), anyDirection( anyDirection ), implementWidth( implementWidth ), passNumber( passNumber ) {}
 
   public:
-    bool operator==( PathPrimitiveLine& b ) {
-      return passNumber == b.passNumber;
-    }
-    bool operator==( const PathPrimitiveLine& b )const {
+    bool operator==( const PathPrimitiveLine& b ) const {
       return passNumber == b.passNumber;
     }
 
   public:
-    void reverse();
+    void reverse() {
+      line = line.opposite();
+    }
 
   public:
-    virtual double distanceToPoint( const Point_2& point ) override;
-    virtual void print() override;
+    double distanceToPoint( const Point_2& point ) const;
+    void print() const;
 
   public:
     Line_2 line;
+    bool anyDirection = false;
+    double implementWidth = 0;
+    int32_t passNumber = 0;
 };
 
-class PathPrimitiveSegment : public PathPrimitive {
+class PathPrimitiveSegment {
   public:
-    PathPrimitiveSegment()
-      : PathPrimitive() {}
+    PathPrimitiveSegment() {}
 
     PathPrimitiveSegment( const Segment_2& segment, double implementWidth, bool anyDirection, int32_t passNumber )
-      : PathPrimitive( anyDirection, implementWidth, passNumber ), segment( segment ) {}
-
-    virtual Type getType() override {
-      return Type::Segment;
-    }
+      : segment( segment ), anyDirection( anyDirection ), implementWidth( implementWidth ), passNumber( passNumber ) {}
 
   public:
-    bool operator==( PathPrimitiveSegment& b ) {
-      return segment == b.segment;
-    }
     bool operator==( const PathPrimitiveSegment& b ) const {
       return segment == b.segment;
     }
 
   public:
-    void reverse();
+    void reverse() {
+      segment = segment.opposite();
+    }
 
   public:
-    virtual double distanceToPoint( const Point_2& point ) override;
-    virtual void print() override;
+    double distanceToPoint( const Point_2& point ) const;
+    void print() const;
 
   public:
     Segment_2 segment;
+    bool anyDirection = false;
+    double implementWidth = 0;
+    int32_t passNumber = 0;
 };
 
-//class PathPrimitiveCircle : public PathPrimitive {
-//  public:
-//    PathPrimitiveCircle() : PathPrimitive() {}
-
-//    PathPrimitiveCircle( QPointF center, QPointF start, QPointF end, bool anyDirection, int passNumber )
-//      : PathPrimitive( anyDirection, 0, passNumber ),
-//        center( center ), start( start ), end( end ) {}
-
-//    virtual Type getType() override{
-//      return Type::Circle;
-//    }
-
-//  public:
-//    virtual double distanceToPoint( const Point_2& ) override;
-
-//  public:
-//    QPointF center;
-//    QPointF start;
-//    QPointF end;
-//};
+// get the concrete primitive with boost::get<PathPrimitiveLine>( &primitive ), which returns nullptr for the other types
+using PathPrimitive = boost::variant<PathPrimitiveLine, PathPrimitiveSegment>;
 
+double distanceToPoint( const PathPrimitive& primitive, const Point_2& point );
@@ -21,6 +21,9 @@
 #include "../cgalKernel.h"
 #include "PathPrimitive.h"
 
+#include <cmath>
+#include <map>
+
 class Plan {
   public:
     enum class Type : uint8_t {
@@ -30,19 +33,103 @@ class Plan {
       Mixed = 100
     };
 
-    Plan() {
-      plan = std::make_shared<std::vector<std::shared_ptr<PathPrimitive>>>();
-    }
+    Plan()
+      : plan( std::make_shared<const std::vector<PathPrimitive>>() ) {}
 
     Plan( const Type type )
-      : type( type ) {
-      plan = std::make_shared<std::vector<std::shared_ptr<PathPrimitive>>>();
+      : type( type ), plan( std::make_shared<const std::vector<PathPrimitive>>() ) {}
+
+    Plan( const Type type, std::vector<PathPrimitive>&& primitives )
+      : type( type ), plan( std::make_shared<const std::vector<PathPrimitive>>( std::move( primitives ) ) ) {}
+
+
+    // for a plan of parallel lines with the same distance between them, sorted by their offset (like the AB lines):
+    // the first line and the offset from one line to the next. The nearest line is then found in constant time
+    void setParallelLines( const Line_2& firstLine, const Vector_2& offsetToNextLine ) {
+      const double length = std::sqrt( firstLine.to_vector().squared_length() );
+
+      if( length > 0 ) {
+        originX = firstLine.point( 0 ).x();
+        originY = firstLine.point( 0 ).y();
+        directionX = firstLine.to_vector().x() / length;
+        directionY = firstLine.to_vector().y() / length;
+
+        // the offset between the lines across their direction; signed like the distances below
+        spacing = directionX * offsetToNextLine.y() - directionY * offsetToNextLine.x();
+        parallelLines = !qFuzzyIsNull( spacing );
+      }
+    }
+
+    // index of the line nearest to the point, -1 if the plan isn't made of parallel lines
+    // outside of the plan, this is the first or the last line, like a search through the lines would return
+    int indexOfNearestParallelLine( const Point_2& point ) const {
+      if( !parallelLines || plan->empty() ) {
+        return -1;
+      }
+
+      // the distance to the left of the first line, in multiples of the offset to the next line
+      const double distance = directionX * ( point.y() - originY ) - directionY * ( point.x() - originX );
+      const double index = std::round( distance / spacing );
+
+      return int( qBound( 0., index, double( plan->size() - 1 ) ) );
     }
 
+    // distance from the point to the end of the pass inside of the field, going in the direction:
+    // to the exit of the part of the pass the point is on or heading to, negative after the last part.
+    // qInf(), if the pass isn't clipped to a field
+    double distanceToEndOfPass( const int32_t passNumber, const Point_2& point, const Vector_2& direction ) const {
+      if( !segmentsInField ) {
+        return qInf();
+      }
+
+      const auto segments = segmentsInField->find( passNumber );
+
+      if( segments == segmentsInField->cend() ) {
+        return qInf();
+      }
+
+      // a pass outside of the field ends right away
+      if( segments->second.empty() ) {
+        return 0;
+      }
+
+      const double length = std::sqrt( direction.squared_length() );
+      double distanceToNextEnd = qInf();
+      double distanceToLastEnd = -qInf();
+
+      for( const auto& segment : segments->second ) {
+        const double distanceToSource = ( segment.source() - point ) * direction / length;
+        const double distanceToTarget = ( segment.target() - point ) * direction / length;
+        const double distanceToEnd = std::max( distanceToSource, distanceToTarget );
+
+        if( distanceToEnd >= 0 ) {
+          distanceToNextEnd = std::min( distanceToNextEnd, distanceToEnd );
+        } else {
+          distanceToLastEnd = std::max( distanceToLastEnd, distanceToEnd );
+        }
+      }
+
+      return std::isinf( distanceToNextEnd ) ? distanceToLastEnd : distanceToNextEnd;
+    }
 
   public:
     Type type = Type::Mixed;
-    std::shared_ptr<std::vector<std::shared_ptr<PathPrimitive>>> plan;
+
+    // an immutable snapshot: the receivers share it with one reference count for the whole plan.
+    // To change a plan, make a new one
+    std::shared_ptr<const std::vector<PathPrimitive>> plan;
+
+    // the parts of the passes inside of the field by pass number, sorted along the pass, for the planners clipping
+    // their passes to a field. Intersected once when a pass is made, so the receivers don't have to
+    std::shared_ptr<const std::map<int32_t, std::vector<Segment_2>>> segmentsInField;
+
+  private:
+    bool parallelLines = false;
+    double originX = 0;
+    double originY = 0;
+    double directionX = 0;
+    double directionY = 0;
+    double spacing = 0;
 };
 
 Q_DECLARE_METATYPE( Plan )
@@ -0,0 +1,108 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <QObject>
+#include <QQuaternion>
+#include <QVector3D>
+
+#include <chrono>
+
+#include "../cgalKernel.h"
+#include "PoseOptions.h"
+
+// immutable pose message: position, orientation and flags, stamped with the time of acquisition
+// and a sequence number. The euler angles are calculated once on construction, so the consumers
+// don't have to convert the quaternion for every message.
+class Pose {
+  public:
+    Pose() = default;
+
+    Pose( const Point_3& position, const QQuaternion& orientation, const PoseOption::Options options,
+          const qint64 timestamp, const quint64 sequence )
+      : m_position( position ), m_orientation( orientation ), m_options( options ),
+        m_timestamp( timestamp ), m_sequence( sequence ) {
+      // same convention as the rest of the code: x = pitch, y = roll, z = heading
+      QVector3D eulerAngles = orientation.toEulerAngles();
+      m_pitch = eulerAngles.x();
+      m_roll = eulerAngles.y();
+      m_yaw = eulerAngles.z();
+    }
+
+    // timestamp source for new poses: monotonic clock in ns
+    static qint64 now() {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     std::chrono::steady_clock::now().time_since_epoch() ).count();
+    }
+
+    const Point_3& position() const {
+      return m_position;
+    }
+    const QQuaternion& orientation() const {
+      return m_orientation;
+    }
+    PoseOption::Options options() const {
+      return m_options;
+    }
+    qint64 timestamp() const {
+      return m_timestamp;
+    }
+    quint64 sequence() const {
+      return m_sequence;
+    }
+
+    // in degrees
+    float yaw() const {
+      return m_yaw;
+    }
+    float roll() const {
+      return m_roll;
+    }
+    float pitch() const {
+      return m_pitch;
+    }
+
+    // derived poses keep the timestamp and the sequence number of the original
+    Pose withPosition( const Point_3& position ) const {
+      Pose pose = *this;
+      pose.m_position = position;
+      return pose;
+    }
+    Pose withOrientation( const QQuaternion& orientation ) const {
+      return Pose( m_position, orientation, m_options, m_timestamp, m_sequence );
+    }
+    Pose withOptions( const PoseOption::Options options ) const {
+      Pose pose = *this;
+      pose.m_options = options;
+      return pose;
+    }
+
+  private:
+    Point_3 m_position = Point_3( 0, 0, 0 );
+    QQuaternion m_orientation = QQuaternion();
+    PoseOption::Options m_options = PoseOption::NoOptions;
+    qint64 m_timestamp = 0;
+    quint64 m_sequence = 0;
+
+    float m_yaw = 0;
+    float m_roll = 0;
+    float m_pitch = 0;
+};
+
+Q_DECLARE_METATYPE( Pose )
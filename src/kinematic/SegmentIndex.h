@@ -0,0 +1,245 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include "../cgalKernel.h"
+#include "PathPrimitive.h"
+#include "Plan.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+
+// finds the segment of a plan nearest to a point, for curved AB lines and contours with thousands of segments:
+// a uniform grid over the bounding boxes of the segments, searched in rings around the cell of the point.
+// The search starts with the last nearest segment and its neighbours in the chain, so a moving vehicle usually
+// only has to look into the cells next to it
+class SegmentIndex {
+  public:
+    void build( const Plan& plan ) {
+      clear();
+
+      double minX = std::numeric_limits<double>::infinity();
+      double minY = std::numeric_limits<double>::infinity();
+      double maxX = -std::numeric_limits<double>::infinity();
+      double maxY = -std::numeric_limits<double>::infinity();
+      double sumOfLengths = 0;
+      size_t numSegments = 0;
+
+      for( const auto& primitive : *plan.plan ) {
+        if( const auto* pathSegment = boost::get<PathPrimitiveSegment>( &primitive ) ) {
+          const auto bbox = pathSegment->segment.bbox();
+          minX = std::min( minX, bbox.xmin() );
+          minY = std::min( minY, bbox.ymin() );
+          maxX = std::max( maxX, bbox.xmax() );
+          maxY = std::max( maxY, bbox.ymax() );
+          sumOfLengths += std::sqrt( pathSegment->segment.squared_length() );
+          ++numSegments;
+        }
+      }
+
+      if( numSegments == 0 ) {
+        return;
+      }
+
+      primitives = plan.plan;
+      originX = minX;
+      originY = minY;
+
+      // cells about the length of an average segment, but only a few cells per segment
+      cellSize = std::max( sumOfLengths / numSegments, 0.1 );
+
+      while( ( ( maxX - minX ) / cellSize + 1 ) * ( ( maxY - minY ) / cellSize + 1 ) > 4. * numSegments ) {
+        cellSize *= 2;
+      }
+
+      numCellsX = int( ( maxX - minX ) / cellSize ) + 1;
+      numCellsY = int( ( maxY - minY ) / cellSize ) + 1;
+
+      // the segments are stored by cell in one vector: count them first, then fill in
+      cellStart.assign( size_t( numCellsX * numCellsY + 1 ), 0 );
+      forEachCellOfSegments( [this]( int cell, uint32_t ) {
+        ++cellStart[size_t( cell ) + 1];
+      } );
+
+      for( size_t i = 1; i < cellStart.size(); ++i ) {
+        cellStart[i] += cellStart[i - 1];
+      }
+
+      cellSegments.resize( cellStart.back() );
+      std::vector<uint32_t> fillPosition( cellStart.cbegin(), cellStart.cend() - 1 );
+      forEachCellOfSegments( [this, &fillPosition]( int cell, uint32_t index ) {
+        cellSegments[fillPosition[size_t( cell )]++] = index;
+      } );
+
+      visited.assign( primitives->size(), 0 );
+    }
+
+    void clear() {
+      primitives.reset();
+      cellStart.clear();
+      cellSegments.clear();
+      visited.clear();
+      numCellsX = numCellsY = 0;
+      lastNearest = -1;
+    }
+
+    // index into the plan of the segment nearest to the point, -1 if the plan has no segments
+    int nearestSegment( const Point_2& point ) {
+      if( cellStart.empty() ) {
+        return -1;
+      }
+
+      // a new stamp for every search, so the segments spanning more than one cell are only measured once
+      if( ++currentStamp == 0 ) {
+        std::fill( visited.begin(), visited.end(), 0 );
+        currentStamp = 1;
+      }
+
+      int nearest = -1;
+      double nearestDistanceSquared = std::numeric_limits<double>::infinity();
+
+      const auto measure = [&]( const int index ) {
+        if( index >= 0 && size_t( index ) < primitives->size() && visited[size_t( index )] != currentStamp ) {
+          visited[size_t( index )] = currentStamp;
+
+          if( const auto* pathSegment = boost::get<PathPrimitiveSegment>( &( *primitives )[size_t( index )] ) ) {
+            const double distanceSquared = CGAL::squared_distance( pathSegment->segment, point );
+
+            if( distanceSquared < nearestDistanceSquared ) {
+              nearest = index;
+              nearestDistanceSquared = distanceSquared;
+            }
+          }
+        }
+      };
+
+      const auto measureCell = [&]( const int x, const int y ) {
+        const size_t cell = size_t( y * numCellsX + x );
+
+        for( uint32_t i = cellStart[cell]; i < cellStart[cell + 1]; ++i ) {
+          measure( int( cellSegments[i] ) );
+        }
+      };
+
+      // the last nearest segment and its neighbours give a good first guess...
+      if( lastNearest >= 0 ) {
+        measure( lastNearest );
+        measure( lastNearest - 1 );
+        measure( lastNearest + 1 );
+      }
+
+      // ...which ends the search through the rings of cells early
+      const int cellX = qBound( 0, int( std::floor( ( point.x() - originX ) / cellSize ) ), numCellsX - 1 );
+      const int cellY = qBound( 0, int( std::floor( ( point.y() - originY ) / cellSize ) ), numCellsY - 1 );
+
+      for( int ring = 0; ; ++ring ) {
+        const int lowX = cellX - ring;
+        const int highX = cellX + ring;
+        const int lowY = cellY - ring;
+        const int highY = cellY + ring;
+
+        for( int y = std::max( 0, lowY ); y <= std::min( numCellsY - 1, highY ); ++y ) {
+          if( y == lowY || y == highY ) {
+            for( int x = std::max( 0, lowX ); x <= std::min( numCellsX - 1, highX ); ++x ) {
+              measureCell( x, y );
+            }
+          } else {
+            if( lowX >= 0 ) {
+              measureCell( lowX, y );
+            }
+
+            if( highX < numCellsX ) {
+              measureCell( highX, y );
+            }
+          }
+        }
+
+        // the segments not measured yet lie in the cells outside of the rings; the sides of the rings at the
+        // border of the grid have no cells behind them
+        double distanceToOutside = std::numeric_limits<double>::infinity();
+
+        if( lowX > 0 ) {
+          distanceToOutside = std::min( distanceToOutside, point.x() - ( originX + lowX * cellSize ) );
+        }
+
+        if( highX < numCellsX - 1 ) {
+          distanceToOutside = std::min( distanceToOutside, ( originX + ( highX + 1 ) * cellSize ) - point.x() );
+        }
+
+        if( lowY > 0 ) {
+          distanceToOutside = std::min( distanceToOutside, point.y() - ( originY + lowY * cellSize ) );
+        }
+
+        if( highY < numCellsY - 1 ) {
+          distanceToOutside = std::min( distanceToOutside, ( originY + ( highY + 1 ) * cellSize ) - point.y() );
+        }
+
+        if( std::isinf( distanceToOutside ) ||
+            ( distanceToOutside > 0 && distanceToOutside * distanceToOutside >= nearestDistanceSquared ) ) {
+          break;
+        }
+      }
+
+      lastNearest = nearest;
+      return nearest;
+    }
+
+  private:
+    template<typename Function>
+    void forEachCellOfSegments( Function function ) {
+      for( size_t index = 0; index < primitives->size(); ++index ) {
+        if( const auto* pathSegment = boost::get<PathPrimitiveSegment>( &( *primitives )[index] ) ) {
+          const auto bbox = pathSegment->segment.bbox();
+          const int lowX = qBound( 0, int( ( bbox.xmin() - originX ) / cellSize ), numCellsX - 1 );
+          const int highX = qBound( 0, int( ( bbox.xmax() - originX ) / cellSize ), numCellsX - 1 );
+          const int lowY = qBound( 0, int( ( bbox.ymin() - originY ) / cellSize ), numCellsY - 1 );
+          const int highY = qBound( 0, int( ( bbox.ymax() - originY ) / cellSize ), numCellsY - 1 );
+
+          for( int y = lowY; y <= highY; ++y ) {
+            for( int x = lowX; x <= highX; ++x ) {
+              function( y * numCellsX + x, uint32_t( index ) );
+            }
+          }
+        }
+      }
+    }
+
+  private:
+    // the plan the index was built for, kept alive as the index points into it
+    std::shared_ptr<const std::vector<PathPrimitive>> primitives;
+
+    double originX = 0;
+    double originY = 0;
+    double cellSize = 1;
+    int numCellsX = 0;
+    int numCellsY = 0;
+
+    // the segments of cell i are cellSegments[cellStart[i]] to cellSegments[cellStart[i+1]-1]
+    std::vector<uint32_t> cellStart;
+    std::vector<uint32_t> cellSegments;
+
+    std::vector<uint32_t> visited;
+    uint32_t currentStamp = 0;
+
+    int lastNearest = -1;
+};
@@ -28,6 +28,7 @@
 #include <QSettings>
 #include <QStandardPaths>
 #include <QEvent>
+#include <QCommandLineParser>
 
 #include <Qt3DRender/QCamera>
 #include <Qt3DCore/QEntity>
@@ -75,6 +76,7 @@
 #include "gui/PassToolbar.h"
 #include "gui/FieldsToolbar.h"
 #include "gui/FieldsOptimitionToolbar.h"
+#include "gui/HeadlessRunner.h"
 
 #include "block/CameraController.h"
 #include "block/FpsMeasurement.h"
@@ -85,12 +87,16 @@
 #include "block/ValueDockBlock.h"
 #include "block/PositionDockBlock.h"
 #include "block/OrientationDockBlock.h"
+#include "block/LatencyDockBlock.h"
 
 #include "block/PoseSimulation.h"
 #include "block/PoseSynchroniser.h"
 
 #include "kinematic/FixedKinematic.h"
 #include "kinematic/TrailerKinematic.h"
+#include "kinematic/Pose.h"
+
+#include "helpers/SimulationClock.h"
 
 #include "qneblock.h"
 #include "qneconnection.h"
@@ -122,10 +128,67 @@ int main( int argc, char** argv ) {
   // make qDebug() more expressive
 //  qSetMessagePattern( "%{file}:%{line}, %{function}: %{message}" );
 
+  // headless: run a saved config without the 3D view and the widgets
+  bool headless = false;
+
+  for( int i = 1; i < argc; ++i ) {
+    if( qstrcmp( argv[i], "--headless" ) == 0 ) {
+      headless = true;
+    }
+  }
+
+  // not a QCoreApplication: the graph of the blocks lives in a QGraphicsScene (QNEBlock and QNEPort are
+  // QGraphicsItems), which needs a QApplication. The offscreen platform runs it without a display
+  if( headless ) {
+    qputenv( "QT_QPA_PLATFORM", "offscreen" );
+  }
+
   QApplication app( argc, argv );
   QApplication::setOrganizationDomain( QStringLiteral( "QtOpenGuidance.org" ) );
   QApplication::setApplicationName( QStringLiteral( "QtOpenGuidance" ) );
 
+  // the poses are sent by value through queued connections and the ports, so register them once
+  qRegisterMetaType<Pose>( "Pose" );
+
+  QCommandLineParser parser;
+  QCommandLineOption headlessOption( QStringLiteral( "headless" ), QStringLiteral( "Run without the 3D view and the widgets." ) );
+  QCommandLineOption configOption( QStringLiteral( "config" ), QStringLiteral( "Config to run." ), QStringLiteral( "file" ) );
+  QCommandLineOption virtualTimeOption( QStringLiteral( "virtual-time" ), QStringLiteral( "Run the simulation in virtual time, as fast as possible." ) );
+  QCommandLineOption durationOption( QStringLiteral( "duration" ), QStringLiteral( "Quit after the given simulated seconds." ), QStringLiteral( "seconds" ) );
+  parser.addOption( headlessOption );
+  parser.addOption( configOption );
+  parser.addOption( virtualTimeOption );
+  parser.addOption( durationOption );
+  parser.parse( QApplication::arguments() );
+
+  // the clock has to be set up in the GUI thread, before the first block starts a timer
+  auto& simulationClock = SimulationClock::instance();
+
+  if( parser.isSet( virtualTimeOption ) ) {
+    simulationClock.setMode( SimulationClock::Mode::Virtual );
+  }
+
+  if( parser.isSet( durationOption ) ) {
+    simulationClock.setEndTime( qint64( parser.value( durationOption ).toDouble() * 1e9 ) );
+    QObject::connect( &simulationClock, &SimulationClock::finished,
+                      &app, &QCoreApplication::quit );
+  }
+
+  if( headless ) {
+    if( !parser.isSet( configOption ) ) {
+      qWarning() << "--headless needs a config: --config <file>";
+      return 1;
+    }
+
+    HeadlessRunner headlessRunner;
+
+    if( !headlessRunner.loadConfig( parser.value( configOption ) ) ) {
+      return 1;
+    }
+
+    return QApplication::exec();
+  }
+
 #if !defined(Q_OS_LINUX) || defined(Q_OS_ANDROID)
   QIcon::setThemeSearchPaths( QIcon::themeSearchPaths() << QStringLiteral( ":themes/" ) );
   QIcon::setThemeName( QStringLiteral( "oxygen" ) );
@@ -362,6 +425,13 @@ int main( int argc, char** argv ) {
     guidanceToolbar->menu );
   positionDockBlockFactory->addToCombobox( settingDialog->getCbNodeType() );
 
+  // latency dock
+  BlockFactory* latencyDockBlockFactory = new LatencyDockBlockFactory(
+    mainWindow,
+    KDDockWidgets::Location_OnRight,
+    guidanceToolbar->menu );
+  latencyDockBlockFactory->addToCombobox( settingDialog->getCbNodeType() );
+
   // implements
   auto* implementFactory = new ImplementFactory(
     mainWindow,
@@ -39,6 +39,8 @@
 #include <QRectF>
 #include <QtMath>
 
+#include <QThread>
+
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
@@ -55,6 +57,19 @@
 int QNEBlock::m_nextSystemId = int( IdRange::SystemIdStart );
 int QNEBlock::m_nextUserId = int( IdRange::UserIdStart );
 
+namespace {
+  struct BlockIndex {
+    QHash<int, QNEBlock*> byId;
+    QMultiHash<QString, QNEBlock*> byName;
+  };
+
+  // only used from the GUI thread, like the scenes themselves
+  QHash<const QGraphicsScene*, BlockIndex>& blockIndices() {
+    static QHash<const QGraphicsScene*, BlockIndex> indices;
+    return indices;
+  }
+}
+
 QNEBlock::QNEBlock( QObject* object, int id, bool systemBlock, QGraphicsItem* parent )
   : QGraphicsPathItem( parent ),
     systemBlock( systemBlock ), width( 20 ), height( cornerRadius * 2 ), object( object ) {
@@ -94,6 +109,9 @@ QNEBlock::QNEBlock( QObject* object, int id, bool systemBlock, QGraphicsItem* pa
 }
 
 QNEBlock::~QNEBlock() {
+  // ~QGraphicsItem() removes the block from the scene without calling itemChange()
+  removeFromIndex( scene() );
+
   object->deleteLater();
 }
 
@@ -108,7 +126,9 @@ QNEPort* QNEBlock::addPort( const QString& name, QLatin1String signalSlotSignatu
   }
 
   if( ( flags & QNEPort::NamePort ) != 0 ) {
+    removeFromIndex( scene() );
     this->name = name;
+    addToIndex( scene() );
   }
 
   if( ( flags & QNEPort::TypePort ) != 0 ) {
@@ -117,6 +137,15 @@ QNEPort* QNEBlock::addPort( const QString& name, QLatin1String signalSlotSignatu
 
   port->setPortFlags( flags );
 
+  if( ( flags & ( QNEPort::NamePort | QNEPort::TypePort ) ) == 0 ) {
+    auto& ports = isOutput ? outputPorts : inputPorts;
+
+    // the first port with a name wins, like the search through the children did
+    if( !ports.contains( name ) ) {
+      ports.insert( name, port );
+    }
+  }
+
   height += port->getHeightOfLabelBoundingRect();
 
   resizeBlockWidth();
@@ -148,7 +177,15 @@ void QNEBlock::paint( QPainter* painter, const QStyleOptionGraphicsItem* option,
     setZValue( 1 );
   } else {
     painter->setPen( pen() );
-    painter->setBrush( brush() );
+
+    if( heat >= 0 ) {
+      const QColor color = brush().color();
+      painter->setBrush( QColor::fromRgbF( color.redF() + ( 1 - color.redF() ) * heat,
+                                           color.greenF() * ( 1 - heat ),
+                                           color.blueF() * ( 1 - heat ) ) );
+    } else {
+      painter->setBrush( brush() );
+    }
 
     setZValue( 0.5 );
   }
@@ -169,41 +206,91 @@ void QNEBlock::setName( const QString& name, bool setFromLabel ) {
     }
   }
 
+  removeFromIndex( scene() );
   this->name = name;
+  addToIndex( scene() );
 
   auto* obj = qobject_cast<BlockBase*>( object );
 
   if( obj != nullptr ) {
-    obj->setName( name );
+    invokeOnObjectThread( [obj, &name] {
+      obj->setName( name );
+    } );
   }
 
   resizeBlockWidth();
 }
 
+void QNEBlock::setHeat( qreal heat ) {
+  this->heat = qMin( heat, qreal( 1 ) );
+  update();
+}
+
 QVariant QNEBlock::itemChange( GraphicsItemChange change, const QVariant& value ) {
+  if( change == ItemSceneChange ) {
+    removeFromIndex( scene() );
+  }
 
-  Q_UNUSED( change )
+  if( change == ItemSceneHasChanged ) {
+    addToIndex( scene() );
+  }
 
   return value;
 }
 
 QNEPort* QNEBlock::getPortWithName( const QString& name, bool output ) {
-  const auto& constRefOfList = childItems();
+  return ( output ? outputPorts : inputPorts ).value( name, nullptr );
+}
 
-  for( const auto& item : constRefOfList ) {
-    auto* port = qgraphicsitem_cast<QNEPort*>( item );
+QNEBlock* QNEBlock::getBlockWithId( const QGraphicsScene* scene, int id ) {
+  const auto& indices = blockIndices();
+  auto index = indices.constFind( scene );
 
-    if( ( port != nullptr ) &&
-        ( ( port->portFlags() & ( QNEPort::NamePort | QNEPort::TypePort ) ) == 0 ) &&
-        port->isOutput() == output &&
-        port->getName() == name ) {
-      return port;
-    }
+  if( index != indices.cend() ) {
+    return index->byId.value( id, nullptr );
+  }
+
+  return nullptr;
+}
+
+QNEBlock* QNEBlock::getBlockWithName( const QGraphicsScene* scene, const QString& name ) {
+  const auto& indices = blockIndices();
+  auto index = indices.constFind( scene );
+
+  if( index != indices.cend() ) {
+    return index->byName.value( name, nullptr );
   }
 
   return nullptr;
 }
 
+void QNEBlock::addToIndex( const QGraphicsScene* scene ) {
+  if( scene != nullptr ) {
+    auto& index = blockIndices()[scene];
+    index.byId.insert( id, this );
+    index.byName.insert( name, this );
+  }
+}
+
+void QNEBlock::removeFromIndex( const QGraphicsScene* scene ) {
+  if( scene != nullptr ) {
+    auto& indices = blockIndices();
+    auto index = indices.find( scene );
+
+    if( index != indices.end() ) {
+      if( index->byId.value( id, nullptr ) == this ) {
+        index->byId.remove( id );
+      }
+
+      index->byName.remove( name, this );
+
+      if( index->byId.isEmpty() && index->byName.isEmpty() ) {
+        indices.erase( index );
+      }
+    }
+  }
+}
+
 void QNEBlock::toJSON( QJsonObject& json ) {
   QJsonArray blocksArray = json[QStringLiteral( "blocks" )].toArray();
 
@@ -214,7 +301,9 @@ void QNEBlock::toJSON( QJsonObject& json ) {
   blockObject[QStringLiteral( "positionX" )] = x();
   blockObject[QStringLiteral( "positionY" )] = y();
 
-  qobject_cast<BlockBase*>( object )->toJSON( blockObject );
+  invokeOnObjectThread( [this, &blockObject] {
+    qobject_cast<BlockBase*>( object )->toJSON( blockObject );
+  } );
 
   blocksArray.append( blockObject );
 
@@ -223,12 +312,43 @@ void QNEBlock::toJSON( QJsonObject& json ) {
 
 void QNEBlock::fromJSON( QJsonObject& json ) {
   if( json[QStringLiteral( "values" )].isObject() ) {
-    qobject_cast<BlockBase*>( object )->fromJSON( json );
+    invokeOnObjectThread( [this, &json] {
+      qobject_cast<BlockBase*>( object )->fromJSON( json );
+    } );
   }
 }
 
 void QNEBlock::emitConfigSignals() {
-  qobject_cast<BlockBase*>( object )->emitConfigSignals();
+  // the folded connections of a constant block are set directly, the others get the signal
+  const auto& constRefOfList = childItems();
+
+  for( const auto& item : constRefOfList ) {
+    auto* port = qgraphicsitem_cast<QNEPort*>( item );
+
+    if( port != nullptr && port->isOutput() ) {
+      for( auto* connection : port->connections() ) {
+        if( connection->port1() == port && connection->isFolded() ) {
+          connection->applyConstant();
+        }
+      }
+    }
+  }
+
+  // the blocks on the control thread emit their signals there, so the direct connections between them stay on it
+  invokeOnObjectThread( [this] {
+    qobject_cast<BlockBase*>( object )->emitConfigSignals();
+  } );
+}
+
+void QNEBlock::invokeOnObjectThread( const std::function<void()>& function ) {
+  QThread* thread = object->thread();
+
+  // a stopped thread can't run it, but nothing can race with it either
+  if( thread == QThread::currentThread() || !thread->isRunning() ) {
+    function();
+  } else {
+    QMetaObject::invokeMethod( object, function, Qt::BlockingQueuedConnection );
+  }
 }
 
 void QNEBlock::resizeBlockWidth() {
@@ -28,6 +28,9 @@
 #pragma once
 
 #include <QGraphicsPathItem>
+#include <QHash>
+
+#include <functional>
 
 class QNEPort;
 
@@ -57,6 +60,10 @@ class QNEBlock : public QGraphicsPathItem {
     void fromJSON( QJsonObject& json );
     void emitConfigSignals();
 
+    // runs function on the thread of the object and waits for it: the GUI mustn't touch an object on the
+    // control thread directly
+    void invokeOnObjectThread( const std::function<void()>& function );
+
     int type() const override {
       return Type;
     }
@@ -66,6 +73,13 @@ class QNEBlock : public QGraphicsPathItem {
 
     QNEPort* getPortWithName( const QString& name, bool output );
 
+    // the blocks of every scene are indexed by id and name, so the lookup doesn't walk the whole scene
+    static QNEBlock* getBlockWithId( const QGraphicsScene* scene, int id );
+    static QNEBlock* getBlockWithName( const QGraphicsScene* scene, const QString& name );
+
+    // 0 to 1: tints the block from its colour to red; negative to disable
+    void setHeat( qreal heat );
+
     bool systemBlock = false;
 
   public:
@@ -91,6 +105,9 @@ class QNEBlock : public QGraphicsPathItem {
     static int m_nextSystemId;
     static int m_nextUserId;
 
+    void addToIndex( const QGraphicsScene* scene );
+    void removeFromIndex( const QGraphicsScene* scene );
+
   protected:
     QVariant itemChange( GraphicsItemChange change, const QVariant& value ) override;
     void mouseReleaseEvent( QGraphicsSceneMouseEvent* event ) override;
@@ -98,8 +115,13 @@ class QNEBlock : public QGraphicsPathItem {
   private:
     qreal width = 0;
     qreal height = 0;
+    qreal heat = -1;
     QString name;
 
+    // the ports by their name, without the name and type ports
+    QHash<QString, QNEPort*> inputPorts;
+    QHash<QString, QNEPort*> outputPorts;
+
   public:
     const QString getName() {
       return name;
@@ -30,11 +30,14 @@
 #include "qneport.h"
 #include "qneblock.h"
 
+#include "../block/BlockBase.h"
+
 #include <QObject>
 #include <QBrush>
 #include <QPen>
 #include <QGraphicsScene>
 #include <QPainter>
+#include <QMetaMethod>
 
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -71,16 +74,24 @@ QNEConnection::~QNEConnection() {
   }
 
   QObject::disconnect( connection );
+
+  // the relay lives in the thread of the receiver
+  if( relay != nullptr ) {
+    relay->deleteLater();
+  }
 }
 
 
 void QNEConnection::paint( QPainter* painter, const QStyleOptionGraphicsItem*, QWidget* ) {
+  // the connections with a queue policy are dashed
+  const Qt::PenStyle style = ( policy == QNEConnectionPolicy::Direct ) ? Qt::SolidLine : Qt::DashLine;
+
   if( isSelected() ) {
-    painter->setPen( QPen( Qt::red, 3 ) );
+    painter->setPen( QPen( Qt::red, 3, style ) );
     painter->setBrush( Qt::NoBrush );
     setZValue( 1.5 );
   } else {
-    painter->setPen( QPen( Qt::darkGreen, 3 ) );
+    painter->setPen( QPen( Qt::darkGreen, 3, style ) );
     painter->setBrush( Qt::NoBrush );
     setZValue( 0 );
   }
@@ -119,6 +130,201 @@ bool QNEConnection::setPort2( QNEPort* p ) {
   return false;
 }
 
+bool QNEConnection::resolveMethods( QMetaMethod& signal, QMetaMethod& slot ) const {
+  if( m_port1 == nullptr || m_port2 == nullptr ) {
+    return false;
+  }
+
+  QObject* sender = m_port1->block()->object;
+  QObject* receiver = m_port2->block()->object;
+
+  // the signatures are from SIGNAL() and SLOT(), so skip the code in the first character
+  const int signalIndex = sender->metaObject()->indexOfSignal(
+                            QMetaObject::normalizedSignature( m_port1->slotSignalSignature.latin1() + 1 ).constData() );
+  const int methodIndex = receiver->metaObject()->indexOfMethod(
+                            QMetaObject::normalizedSignature( m_port2->slotSignalSignature.latin1() + 1 ).constData() );
+
+  if( signalIndex < 0 || methodIndex < 0 ) {
+    return false;
+  }
+
+  signal = sender->metaObject()->method( signalIndex );
+  slot = receiver->metaObject()->method( methodIndex );
+
+  return true;
+}
+
+bool QNEConnection::reconnect( Qt::ConnectionType connectionType ) {
+  // the relay is connected directly and delivers in the thread of the receiver anyway
+  if( relay != nullptr ) {
+    return relay->isConnected();
+  }
+
+  // folded connections have no signal to connect
+  if( folded ) {
+    return true;
+  }
+
+  QMetaMethod signal;
+  QMetaMethod slot;
+
+  if( !resolveMethods( signal, slot ) ) {
+    return false;
+  }
+
+  QObject::disconnect( connection );
+
+  connection = QObject::connect( m_port1->block()->object, signal,
+                                 m_port2->block()->object, slot,
+                                 connectionType );
+
+  return bool( connection );
+}
+
+bool QNEConnection::setPolicy( QNEConnectionPolicy policy, int fifoSize, double rateHz ) {
+  QMetaMethod signal;
+  QMetaMethod slot;
+
+  if( !resolveMethods( signal, slot ) ) {
+    return false;
+  }
+
+  QObject::disconnect( connection );
+  folded = false;
+
+  if( relay != nullptr ) {
+    relay->deleteLater();
+    relay = nullptr;
+  }
+
+  this->policy = policy;
+  this->fifoSize = fifoSize;
+  this->rateHz = rateHz;
+
+  if( policy != QNEConnectionPolicy::Direct ) {
+    relay = new QNEConnectionRelay( m_port1->block()->object, signal,
+                                    m_port2->block()->object, slot,
+                                    policy, fifoSize, rateHz );
+
+    if( relay->isConnected() ) {
+      update();
+      return true;
+    }
+
+    relay->deleteLater();
+    relay = nullptr;
+    this->policy = QNEConnectionPolicy::Direct;
+  }
+
+  connection = QObject::connect( m_port1->block()->object, signal,
+                                 m_port2->block()->object, slot,
+                                 Qt::AutoConnection );
+
+  update();
+
+  return policy == QNEConnectionPolicy::Direct;
+}
+
+QString QNEConnection::policyDescription() const {
+  switch( policy ) {
+    case QNEConnectionPolicy::LatestValue:
+      return QStringLiteral( "Latest Value: %1 delivered, %2 coalesced" )
+             .arg( relay ? relay->delivered() : 0 ).arg( relay ? relay->coalesced() : 0 );
+
+    case QNEConnectionPolicy::Fifo:
+      return QStringLiteral( "FIFO of %1: %2 delivered, %3 dropped" )
+             .arg( fifoSize ).arg( relay ? relay->delivered() : 0 ).arg( relay ? relay->dropped() : 0 );
+
+    case QNEConnectionPolicy::Decimate:
+      return QStringLiteral( "Decimate to %1 Hz: %2 delivered, %3 dropped" )
+             .arg( rateHz ).arg( relay ? relay->delivered() : 0 ).arg( relay ? relay->dropped() : 0 );
+
+    default:
+      return QStringLiteral( "Direct" );
+  }
+}
+
+bool QNEConnection::fold() {
+  if( policy != QNEConnectionPolicy::Direct || folded ) {
+    return folded;
+  }
+
+  auto* sender = qobject_cast<BlockBase*>( m_port1->block()->object );
+
+  if( sender == nullptr || !sender->constantValue().isValid() ) {
+    return false;
+  }
+
+  QMetaMethod signal;
+  QMetaMethod slot;
+
+  if( !resolveMethods( signal, slot ) ) {
+    return false;
+  }
+
+  if( slot.parameterCount() > 1 ||
+      ( slot.parameterCount() == 1 && !sender->constantValue().canConvert( slot.parameterType( 0 ) ) ) ) {
+    return false;
+  }
+
+  QObject::disconnect( connection );
+  folded = true;
+
+  return true;
+}
+
+void QNEConnection::applyConstant() {
+  QMetaMethod signal;
+  QMetaMethod slot;
+
+  if( !folded || !resolveMethods( signal, slot ) ) {
+    return;
+  }
+
+  QObject* receiver = m_port2->block()->object;
+
+  // auto connection: queued, if the receiver runs on the control thread
+  if( slot.parameterCount() == 0 ) {
+    slot.invoke( receiver, Qt::AutoConnection );
+  } else {
+    QVariant value = qobject_cast<BlockBase*>( m_port1->block()->object )->constantValue();
+    value.convert( slot.parameterType( 0 ) );
+    slot.invoke( receiver, Qt::AutoConnection, QGenericArgument( value.typeName(), value.constData() ) );
+  }
+}
+
+QString QNEConnection::policyToString( QNEConnectionPolicy policy ) {
+  switch( policy ) {
+    case QNEConnectionPolicy::LatestValue:
+      return QStringLiteral( "LatestValue" );
+
+    case QNEConnectionPolicy::Fifo:
+      return QStringLiteral( "Fifo" );
+
+    case QNEConnectionPolicy::Decimate:
+      return QStringLiteral( "Decimate" );
+
+    default:
+      return QStringLiteral( "Direct" );
+  }
+}
+
+QNEConnectionPolicy QNEConnection::policyFromString( const QString& string ) {
+  if( string == QLatin1String( "LatestValue" ) ) {
+    return QNEConnectionPolicy::LatestValue;
+  }
+
+  if( string == QLatin1String( "Fifo" ) ) {
+    return QNEConnectionPolicy::Fifo;
+  }
+
+  if( string == QLatin1String( "Decimate" ) ) {
+    return QNEConnectionPolicy::Decimate;
+  }
+
+  return QNEConnectionPolicy::Direct;
+}
+
 void QNEConnection::updatePosFromPorts() {
   pos1 = m_port1->scenePos();
   pos2 = m_port2->scenePos();
@@ -156,7 +362,22 @@ void QNEConnection::toJSON( QJsonObject& json ) {
   connectionObject[QStringLiteral( "portFrom" )] = port1()->getName();
   connectionObject[QStringLiteral( "idTo" )] =  port2()->block()->id;
   connectionObject[QStringLiteral( "portTo" )] = port2()->getName();
+
+  // only saved if set, so the configs without policies stay as they are
+  if( policy != QNEConnectionPolicy::Direct ) {
+    connectionObject[QStringLiteral( "policy" )] = policyToString( policy );
+    connectionObject[QStringLiteral( "fifoSize" )] = fifoSize;
+    connectionObject[QStringLiteral( "rateHz" )] = rateHz;
+  }
   connectionsArray.append( connectionObject );
 
   json[QStringLiteral( "connections" )] = connectionsArray;
 }
+
+void QNEConnection::fromJSON( const QJsonObject& json ) {
+  if( json.contains( QStringLiteral( "policy" ) ) ) {
+    setPolicy( policyFromString( json[QStringLiteral( "policy" )].toString() ),
+               json[QStringLiteral( "fifoSize" )].toInt( 16 ),
+               json[QStringLiteral( "rateHz" )].toDouble( 10 ) );
+  }
+}
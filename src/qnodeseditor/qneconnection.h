@@ -28,8 +28,11 @@
 #pragma once
 
 #include <QObject>
+#include <QPointer>
 #include <QGraphicsPathItem>
 
+#include "qneconnectionrelay.h"
+
 class QNEPort;
 
 class QNEConnection : public QGraphicsPathItem {
@@ -46,6 +49,38 @@ class QNEConnection : public QGraphicsPathItem {
 
     void setPort1( QNEPort* p );
     bool setPort2( QNEPort* p );
+    // connects the signal and the slot again with the given type; the signal and the slot are resolved to
+    // their QMetaMethod, so no signature strings are parsed on connecting
+    // with a policy other than Direct, the connection goes through a relay and the type is ignored
+    bool reconnect( Qt::ConnectionType connectionType );
+
+    // returns false, if the policy couldn't be set up; the connection is direct then
+    bool setPolicy( QNEConnectionPolicy policy, int fifoSize = 16, double rateHz = 10 );
+    QNEConnectionPolicy getPolicy() const {
+      return policy;
+    }
+    int getFifoSize() const {
+      return fifoSize;
+    }
+    double getRateHz() const {
+      return rateHz;
+    }
+
+    // the policy and the counters of the relay
+    QString policyDescription() const;
+
+    // a connection from a block with a constant value (Number, Vector, String) is disconnected and the value is
+    // set directly on the receiver with applyConstant(), when the block emits its config signals
+    // returns false, if the sender has no constant value or the slot can't take it
+    bool fold();
+    bool isFolded() const {
+      return folded;
+    }
+    void applyConstant();
+
+    static QString policyToString( QNEConnectionPolicy policy );
+    static QNEConnectionPolicy policyFromString( const QString& string );
+
     void updatePosFromPorts();
     void updatePath();
     QNEPort* port1() const;
@@ -56,6 +91,7 @@ class QNEConnection : public QGraphicsPathItem {
     }
 
     void toJSON( QJsonObject& json );
+    void fromJSON( const QJsonObject& json );
 
   private:
     QPointF pos1;
@@ -63,6 +99,15 @@ class QNEConnection : public QGraphicsPathItem {
     QNEPort* m_port1 = nullptr;
     QNEPort* m_port2 = nullptr;
 
+    bool resolveMethods( QMetaMethod& signal, QMetaMethod& slot ) const;
+
     QMetaObject::Connection connection;
+
+    QNEConnectionPolicy policy = QNEConnectionPolicy::Direct;
+    int fifoSize = 16;
+    double rateHz = 10;
+    QPointer<QNEConnectionRelay> relay;
+
+    bool folded = false;
 };
 
@@ -0,0 +1,161 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#include "qneconnectionrelay.h"
+
+#include <QCoreApplication>
+#include <QEvent>
+#include <QMutexLocker>
+#include <QDebug>
+
+#include "../helpers/SimulationClock.h"
+
+QNEConnectionRelay::QNEConnectionRelay( QObject* sender, const QMetaMethod& signal,
+                                        QObject* receiver, const QMetaMethod& slot,
+                                        QNEConnectionPolicy policy, int fifoSize, double rateHz )
+  : QObject(),
+    receiver( receiver ),
+    slot( slot ),
+    policy( policy ),
+    fifoSize( size_t( qMax( fifoSize, 1 ) ) ),
+    minimumInterval( rateHz > 0 ? qint64( 1e9 / rateHz ) : 0 ) {
+  // the slot can take less arguments than the signal; only the ones it takes are copied
+  for( int i = 0; i < slot.parameterCount(); ++i ) {
+    const int type = slot.parameterType( i );
+
+    if( type == QMetaType::UnknownType ) {
+      qWarning() << "QNEConnectionRelay: type not registered:" << slot.parameterTypes().at( i );
+      return;
+    }
+
+    parameterTypes.push_back( type );
+  }
+
+  moveToThread( receiver->thread() );
+  setParent( receiver );
+
+  connection = QMetaObject::connect( sender, signal.methodIndex(),
+                                     this, QObject::staticMetaObject.methodCount(),
+                                     Qt::DirectConnection );
+}
+
+QNEConnectionRelay::~QNEConnectionRelay() {
+  QObject::disconnect( connection );
+
+  for( auto& values : pending ) {
+    destroyArguments( values );
+  }
+}
+
+QEvent::Type QNEConnectionRelay::deliverEventType() {
+  static const auto type = QEvent::Type( QEvent::registerEventType() );
+  return type;
+}
+
+int QNEConnectionRelay::qt_metacall( QMetaObject::Call call, int id, void** arguments ) {
+  id = QObject::qt_metacall( call, id, arguments );
+
+  if( id < 0 || call != QMetaObject::InvokeMetaMethod ) {
+    return id;
+  }
+
+  if( id == 0 ) {
+    enqueue( arguments );
+  }
+
+  return -1;
+}
+
+void QNEConnectionRelay::enqueue( void** arguments ) {
+  QMutexLocker locker( &mutex );
+
+  if( policy == QNEConnectionPolicy::Decimate ) {
+    const qint64 now = SimulationClock::now();
+
+    if( lastAccepted >= 0 && now - lastAccepted < minimumInterval ) {
+      droppedCount.fetch_add( 1, std::memory_order_relaxed );
+      return;
+    }
+
+    lastAccepted = now;
+  }
+
+  // arguments[0] is the return value
+  Arguments values;
+  values.reserve( parameterTypes.size() );
+
+  for( size_t i = 0; i < parameterTypes.size(); ++i ) {
+    values.push_back( QMetaType::create( parameterTypes[i], arguments[i + 1] ) );
+  }
+
+  if( policy == QNEConnectionPolicy::LatestValue && !pending.empty() ) {
+    destroyArguments( pending.front() );
+    pending.front() = std::move( values );
+    coalescedCount.fetch_add( 1, std::memory_order_relaxed );
+  } else {
+    if( policy == QNEConnectionPolicy::Fifo && pending.size() >= fifoSize ) {
+      destroyArguments( pending.front() );
+      pending.pop_front();
+      droppedCount.fetch_add( 1, std::memory_order_relaxed );
+    }
+
+    pending.push_back( std::move( values ) );
+  }
+
+  if( !eventPosted ) {
+    eventPosted = true;
+    QCoreApplication::postEvent( this, new QEvent( deliverEventType() ) );
+  }
+}
+
+bool QNEConnectionRelay::event( QEvent* event ) {
+  if( event->type() == deliverEventType() ) {
+    std::deque<Arguments> values;
+
+    {
+      QMutexLocker locker( &mutex );
+      values.swap( pending );
+      eventPosted = false;
+    }
+
+    void* argumentsOfCall[11] = {};
+
+    for( auto& value : values ) {
+      for( size_t i = 0; i < value.size() && i < 10; ++i ) {
+        argumentsOfCall[i + 1] = value[i];
+      }
+
+      QMetaObject::metacall( receiver, QMetaObject::InvokeMetaMethod, slot.methodIndex(), argumentsOfCall );
+      deliveredCount.fetch_add( 1, std::memory_order_relaxed );
+
+      destroyArguments( value );
+    }
+
+    return true;
+  }
+
+  return QObject::event( event );
+}
+
+void QNEConnectionRelay::destroyArguments( Arguments& values ) const {
+  for( size_t i = 0; i < values.size(); ++i ) {
+    QMetaType::destroy( parameterTypes[i], values[i] );
+  }
+
+  values.clear();
+}
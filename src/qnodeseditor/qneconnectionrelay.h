@@ -0,0 +1,99 @@
+// Copyright( C ) 2020 Christian Riggenbach
+//
+// This program is free software:
+// you can redistribute it and / or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// ( at your option ) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+//      but WITHOUT ANY WARRANTY;
+// without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see < https : //www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <QObject>
+#include <QMetaMethod>
+#include <QMutex>
+
+#include <atomic>
+#include <deque>
+#include <vector>
+
+enum class QNEConnectionPolicy {
+  // a normal connection: called directly in the same thread, queued between threads
+  Direct,
+  // only the latest value is delivered; the values arriving before the receiver gets to it are coalesced
+  LatestValue,
+  // every value is delivered in order, but only fifoSize are kept; the oldest are dropped
+  Fifo,
+  // at most rateHz values per second are delivered, the others are dropped
+  Decimate
+};
+
+// forwards a signal to a slot with a queue policy
+// The relay is a child of the receiver, so it lives in its thread (and moves with it). The signal is connected
+// directly to the relay, which copies the arguments and delivers them with an event in the thread of the receiver,
+// so a fast sender never waits for a slow receiver
+class QNEConnectionRelay : public QObject {
+  public:
+    QNEConnectionRelay( QObject* sender, const QMetaMethod& signal,
+                        QObject* receiver, const QMetaMethod& slot,
+                        QNEConnectionPolicy policy, int fifoSize, double rateHz );
+    ~QNEConnectionRelay() override;
+
+    // false, if the arguments of the slot can't be copied
+    bool isConnected() const {
+      return bool( connection );
+    }
+
+    quint64 delivered() const {
+      return deliveredCount.load( std::memory_order_relaxed );
+    }
+    quint64 coalesced() const {
+      return coalescedCount.load( std::memory_order_relaxed );
+    }
+    quint64 dropped() const {
+      return droppedCount.load( std::memory_order_relaxed );
+    }
+
+    // the signal is connected to the method after the ones of QObject, so the calls end here
+    int qt_metacall( QMetaObject::Call call, int id, void** arguments ) override;
+
+  protected:
+    bool event( QEvent* event ) override;
+
+  private:
+    using Arguments = std::vector<void*>;
+
+    static QEvent::Type deliverEventType();
+
+    void enqueue( void** arguments );
+    void destroyArguments( Arguments& values ) const;
+
+  private:
+    QObject* receiver = nullptr;
+    QMetaMethod slot;
+    std::vector<int> parameterTypes;
+
+    const QNEConnectionPolicy policy;
+    const size_t fifoSize;
+    const qint64 minimumInterval;
+
+    QMutex mutex;
+    std::deque<Arguments> pending;
+    bool eventPosted = false;
+    qint64 lastAccepted = -1;
+
+    std::atomic<quint64> deliveredCount{0};
+    std::atomic<quint64> coalescedCount{0};
+    std::atomic<quint64> droppedCount{0};
+
+    QMetaObject::Connection connection;
+};
@@ -7,6 +7,7 @@ SOURCES += \
     $$PWD/qneblock.cpp \
     $$PWD/qneport.cpp \
     $$PWD/qneconnection.cpp \
+    $$PWD/qneconnectionrelay.cpp \
     $$PWD/qnodeseditor.cpp
 
 HEADERS += \
@@ -15,6 +16,7 @@ HEADERS += \
     $$PWD/qnegraphicsview.h \
     $$PWD/qneport.h \
     $$PWD/qneconnection.h \
+    $$PWD/qneconnectionrelay.h \
     $$PWD/qnodeseditor.h
 
 SOURCES += \
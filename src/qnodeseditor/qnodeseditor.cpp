@@ -35,6 +35,8 @@
 #include <QGraphicsSceneMouseEvent>
 #include <QKeyEvent>
 #include <QScrollBar>
+#include <QMenu>
+#include <QInputDialog>
 
 #include <QDebug>
 
@@ -156,6 +158,19 @@ bool QNodesEditor::eventFilter( QObject* o, QEvent* e ) {
       break;
 
 
+    case QEvent::GraphicsSceneMouseDoubleClick: {
+        if( mouseEvent->button() == Qt::LeftButton ) {
+          auto* connection = qgraphicsitem_cast<QNEConnection*>( itemAt( mouseEvent->scenePos() ) );
+
+          if( connection != nullptr ) {
+            choosePolicy( connection, mouseEvent->screenPos() );
+            return true;
+          }
+        }
+
+        break;
+      }
+
     case QEvent::GraphicsSceneMouseMove: {
         const auto m = static_cast<QGraphicsSceneMouseEvent*>( e );
 
@@ -203,11 +218,7 @@ bool QNodesEditor::eventFilter( QObject* o, QEvent* e ) {
             if( currentConnection->setPort2( port ) ) {
               currentConnection->updatePosFromPorts();
               currentConnection->updatePath();
-              auto* block = qobject_cast<BlockBase*> ( currentConnection->port1()->block()->object );
-
-              if( block != nullptr ) {
-                block->emitConfigSignals();
-              }
+              currentConnection->port1()->block()->emitConfigSignals();
 
               currentConnection = nullptr;
               return true;
@@ -219,11 +230,7 @@ bool QNodesEditor::eventFilter( QObject* o, QEvent* e ) {
             if( currentConnection->setPort2( port1 ) ) {
               currentConnection->updatePosFromPorts();
               currentConnection->updatePath();
-              auto* block = qobject_cast<BlockBase*> ( currentConnection->port1()->block()->object );
-
-              if( block != nullptr ) {
-                block->emitConfigSignals();
-              }
+              currentConnection->port1()->block()->emitConfigSignals();
 
               currentConnection = nullptr;
               return true;
@@ -277,3 +284,47 @@ bool QNodesEditor::eventFilter( QObject* o, QEvent* e ) {
 
   return QObject::eventFilter( o, e );
 }
+
+void QNodesEditor::choosePolicy( QNEConnection* connection, const QPoint& screenPos ) {
+  QMenu menu;
+
+  auto* description = menu.addAction( connection->policyDescription() );
+  description->setEnabled( false );
+  menu.addSeparator();
+
+  auto* directAction = menu.addAction( QStringLiteral( "Direct" ) );
+  auto* latestValueAction = menu.addAction( QStringLiteral( "Latest Value" ) );
+  auto* fifoAction = menu.addAction( QStringLiteral( "FIFO, drop oldest..." ) );
+  auto* decimateAction = menu.addAction( QStringLiteral( "Decimate..." ) );
+
+  const QList<QAction*> policyActions = {directAction, latestValueAction, fifoAction, decimateAction};
+
+  for( auto* action : policyActions ) {
+    action->setCheckable( true );
+  }
+
+  policyActions.at( int( connection->getPolicy() ) )->setChecked( true );
+
+  auto* action = menu.exec( screenPos );
+  bool ok = true;
+
+  if( action == directAction ) {
+    connection->setPolicy( QNEConnectionPolicy::Direct );
+  } else if( action == latestValueAction ) {
+    connection->setPolicy( QNEConnectionPolicy::LatestValue );
+  } else if( action == fifoAction ) {
+    const int fifoSize = QInputDialog::getInt( nullptr, QStringLiteral( "FIFO" ), QStringLiteral( "Size" ),
+                         connection->getFifoSize(), 1, 100000, 1, &ok );
+
+    if( ok ) {
+      connection->setPolicy( QNEConnectionPolicy::Fifo, fifoSize, connection->getRateHz() );
+    }
+  } else if( action == decimateAction ) {
+    const double rateHz = QInputDialog::getDouble( nullptr, QStringLiteral( "Decimate" ), QStringLiteral( "Rate [Hz]" ),
+                          connection->getRateHz(), 0.01, 10000, 2, &ok );
+
+    if( ok ) {
+      connection->setPolicy( QNEConnectionPolicy::Decimate, connection->getFifoSize(), rateHz );
+    }
+  }
+}
@@ -33,6 +33,7 @@ class QGraphicsScene;
 class QNEConnection;
 class QGraphicsItem;
 class QPointF;
+class QPoint;
 class QNEBlock;
 
 class QNodesEditor : public QObject {
@@ -52,6 +53,9 @@ class QNodesEditor : public QObject {
   private:
     QGraphicsItem* itemAt( QPointF );
 
+    // shows a menu to choose the queue policy of the connection
+    void choosePolicy( QNEConnection* connection, const QPoint& screenPos );
+
   private:
     QGraphicsScene* scene = nullptr;
     QNEConnection* currentConnection = nullptr;